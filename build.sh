@@ -28,6 +28,7 @@ if [ $? -eq 0 ]; then
     echo "  ./05_calculator_tests - Real-world example"
     echo "  ./06_mocking_basic    - Basic FakeIt mocking"
     echo "  ./07_mocking_advanced - Advanced mocking scenarios"
+    echo "  ./08_file_processor_tests - FileProcessor with a fake file system"
     echo ""
     echo "To run all tests: ctest"
     echo "To run a specific test: ./test_name"
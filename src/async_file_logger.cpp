@@ -0,0 +1,243 @@
+#include "async_file_logger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const int SPIN_LIMIT = 64;
+
+std::string_view levelTag(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug:
+        return "[DEBUG] ";
+    case LogLevel::Info:
+        return "[INFO] ";
+    case LogLevel::Warning:
+        return "[WARNING] ";
+    case LogLevel::Error:
+        return "[ERROR] ";
+    }
+    return "";
+}
+
+}
+
+// Vyukov's bounded queue: a slot is free for position p when its sequence
+// is p, and holds the record for p once its sequence is p + 1.
+struct AsyncFileLogger::Slot {
+    std::atomic<size_t> sequence;
+    LogLevel level;
+    size_t length;
+    char text[MAX_MESSAGE_SIZE];
+};
+
+AsyncFileLogger::AsyncFileLogger(std::unique_ptr<IFileSystem> fs, const std::string& logFile, size_t capacity,
+                                 OverflowPolicy overflow, size_t sampleEvery)
+    : fileSystem(std::move(fs)), filename(logFile), policy(overflow), sampleRate(sampleEvery),
+      minimumLevel(LogLevel::Debug), enqueuePos(0), dequeuePos(0), drainedPos(0), overflowCount(0), written(0),
+      dropped(0), batches(0), blockedProducers(0), sleeping(false), stopping(false) {
+    if (!fileSystem || !fileSystem->supportsChunkedIo()) {
+        throw std::invalid_argument("Log file system must support chunked I/O");
+    }
+    if (capacity == 0) {
+        throw std::invalid_argument("Logger capacity must be positive");
+    }
+    if (sampleRate == 0) {
+        throw std::invalid_argument("Sample rate must be positive");
+    }
+    size_t rounded = 2;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    slots.reset(new Slot[rounded]);
+    for (size_t i = 0; i < rounded; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mask = rounded - 1;
+    drainer = std::thread([this]() { drainLoop(); });
+}
+
+AsyncFileLogger::~AsyncFileLogger() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping.store(true, std::memory_order_release);
+    }
+    wake.notify_one();
+    drainer.join();
+}
+
+void AsyncFileLogger::info(const std::string& message) {
+    write(LogLevel::Info, message);
+}
+
+void AsyncFileLogger::warning(const std::string& message) {
+    write(LogLevel::Warning, message);
+}
+
+void AsyncFileLogger::error(const std::string& message) {
+    write(LogLevel::Error, message);
+}
+
+void AsyncFileLogger::debug(const std::string& message) {
+    write(LogLevel::Debug, message);
+}
+
+void AsyncFileLogger::write(LogLevel level, const std::string& message) {
+    if (isEnabled(level)) {
+        submit(level, message);
+    }
+}
+
+bool AsyncFileLogger::isEnabled(LogLevel level) const {
+    return level >= minimumLevel.load(std::memory_order_relaxed);
+}
+
+void AsyncFileLogger::setMinimumLevel(LogLevel level) {
+    minimumLevel.store(level, std::memory_order_relaxed);
+}
+
+bool AsyncFileLogger::submit(LogLevel level, std::string_view message) {
+    if (!tryEnqueue(level, message)) {
+        bool keep = policy == OverflowPolicy::Block ||
+                    (policy == OverflowPolicy::Sample &&
+                     overflowCount.fetch_add(1, std::memory_order_relaxed) % sampleRate == sampleRate - 1);
+        if (!keep) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        enqueueBlocking(level, message);
+    }
+    wakeDrainer();
+    return true;
+}
+
+bool AsyncFileLogger::tryEnqueue(LogLevel level, std::string_view message) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots[pos & mask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence == pos) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.level = level;
+                slot.length = std::min(message.size(), MAX_MESSAGE_SIZE);
+                std::memcpy(slot.text, message.data(), slot.length);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (sequence < pos) {
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void AsyncFileLogger::enqueueBlocking(LogLevel level, std::string_view message) {
+    for (int spin = 0; spin < SPIN_LIMIT; ++spin) {
+        wakeDrainer();
+        std::this_thread::yield();
+        if (tryEnqueue(level, message)) {
+            return;
+        }
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    blockedProducers.fetch_add(1);
+    // Pairs with the fence in drainLoop after slots are released.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    space.wait(lock, [&]() { return tryEnqueue(level, message); });
+    blockedProducers.fetch_sub(1);
+}
+
+// Either the drainer sees the record it is about to sleep on, or this sees
+// it asleep and wakes it; the fences order the two checks.
+void AsyncFileLogger::wakeDrainer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wake.notify_one();
+    }
+}
+
+bool AsyncFileLogger::hasRecord() const {
+    return slots[dequeuePos & mask].sequence.load(std::memory_order_acquire) == dequeuePos + 1;
+}
+
+void AsyncFileLogger::drainLoop() {
+    std::string batch;
+    batch.reserve(MAX_BATCH_BYTES + MAX_MESSAGE_SIZE + 16);
+    for (;;) {
+        size_t count = 0;
+        while (batch.size() < MAX_BATCH_BYTES && hasRecord()) {
+            Slot& slot = slots[dequeuePos & mask];
+            batch.append(levelTag(slot.level));
+            batch.append(slot.text, slot.length);
+            batch.push_back('\n');
+            slot.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+            ++dequeuePos;
+            ++count;
+        }
+
+        if (count > 0) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (blockedProducers.load(std::memory_order_relaxed) > 0) {
+                std::lock_guard<std::mutex> lock(mutex);
+                space.notify_all();
+            }
+            
+            bool appended = false;
+            try {
+                appended = fileSystem->appendChunk(filename, batch.data(), batch.size());
+            } catch (...) {
+                appended = false;
+            }
+            if (appended) {
+                written.fetch_add(count, std::memory_order_relaxed);
+                batches.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                dropped.fetch_add(count, std::memory_order_relaxed);
+            }
+            batch.clear();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                drainedPos.store(dequeuePos, std::memory_order_release);
+            }
+            drained.notify_all();
+            continue;
+        }
+
+        // Positions can be claimed before their records are published, so
+        // shutdown waits for the ring to be empty, not just for stopping.
+        if (stopping.load(std::memory_order_acquire) && enqueuePos.load(std::memory_order_acquire) == dequeuePos) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wake.wait(lock, [this]() { return stopping.load(std::memory_order_acquire) || hasRecord(); });
+        sleeping.store(false, std::memory_order_relaxed);
+        if (stopping.load(std::memory_order_acquire) && !hasRecord()) {
+            lock.unlock();
+            std::this_thread::yield();
+        }
+    }
+}
+
+void AsyncFileLogger::flush() {
+    size_t target = enqueuePos.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mutex);
+    wake.notify_one();
+    drained.wait(lock, [this, target]() { return drainedPos.load(std::memory_order_acquire) >= target; });
+}
+
+size_t AsyncFileLogger::capacity() const {
+    return mask + 1;
+}
+
+AsyncLoggerStats AsyncFileLogger::stats() const {
+    AsyncLoggerStats result;
+    result.written = written.load(std::memory_order_relaxed);
+    result.dropped = dropped.load(std::memory_order_relaxed);
+    result.batches = batches.load(std::memory_order_relaxed);
+    return result;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "interfaces.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// What a producer does when the ring is full. Sample drops overflowing
+// records except every sampleRate-th one, which waits for room.
+enum class OverflowPolicy {
+    Drop,
+    Block,
+    Sample
+};
+
+struct AsyncLoggerStats {
+    size_t written = 0;
+    size_t dropped = 0;
+    size_t batches = 0;
+};
+
+// ILogger that never does I/O on the calling thread. Messages are copied
+// into fixed-size records of a bounded lock-free multi-producer ring, and
+// one background thread drains them in order, appending whole batches of
+// "[LEVEL] message" lines to a file. Records are byte strings, so binary
+// payloads pass through unchanged; anything past MAX_MESSAGE_SIZE bytes is
+// cut off. Destruction writes everything logged before it. The file system
+// must report supportsChunkedIo(), since with the IFileSystem default
+// appendChunk every batch would rewrite the whole log.
+class AsyncFileLogger : public ILogger {
+private:
+    struct Slot;
+
+    std::unique_ptr<IFileSystem> fileSystem;
+    std::string filename;
+    OverflowPolicy policy;
+    size_t sampleRate;
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    std::atomic<LogLevel> minimumLevel;
+
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) size_t dequeuePos;
+    std::atomic<size_t> drainedPos;
+    std::atomic<size_t> overflowCount;
+    std::atomic<size_t> written;
+    std::atomic<size_t> dropped;
+    std::atomic<size_t> batches;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable drained;
+    std::condition_variable space;
+    std::atomic<int> blockedProducers;
+    std::atomic<bool> sleeping;
+    std::atomic<bool> stopping;
+    std::thread drainer;
+
+    bool tryEnqueue(LogLevel level, std::string_view message);
+    void enqueueBlocking(LogLevel level, std::string_view message);
+    void wakeDrainer();
+    bool hasRecord() const;
+    void drainLoop();
+
+public:
+    static constexpr size_t MAX_MESSAGE_SIZE = 240;
+    static constexpr size_t DEFAULT_CAPACITY = 8192;
+    static constexpr size_t DEFAULT_SAMPLE_RATE = 16;
+    static constexpr size_t MAX_BATCH_BYTES = 64 * 1024;
+
+    // Capacity is rounded up to a power of two. Throws
+    // std::invalid_argument for a file system without chunked I/O or a
+    // zero capacity or sample rate.
+    AsyncFileLogger(std::unique_ptr<IFileSystem> fs, const std::string& logFile,
+                    size_t capacity = DEFAULT_CAPACITY, OverflowPolicy overflow = OverflowPolicy::Block,
+                    size_t sampleEvery = DEFAULT_SAMPLE_RATE);
+    ~AsyncFileLogger() override;
+
+    AsyncFileLogger(const AsyncFileLogger&) = delete;
+    AsyncFileLogger& operator=(const AsyncFileLogger&) = delete;
+
+    void info(const std::string& message) override;
+    void warning(const std::string& message) override;
+    void error(const std::string& message) override;
+    void debug(const std::string& message) override;
+    void write(LogLevel level, const std::string& message) override;
+    bool isEnabled(LogLevel level) const override;
+
+    void setMinimumLevel(LogLevel level);
+
+    // Returns false when the record was dropped by the overflow policy.
+    bool submit(LogLevel level, std::string_view message);
+    // Waits until every record submitted before the call is in the file.
+    void flush();
+
+    size_t capacity() const;
+    AsyncLoggerStats stats() const;
+};
@@ -0,0 +1,464 @@
+#include "async_file_system.hpp"
+#include <stdexcept>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define ASYNC_FILE_SYSTEM_IO_URING 1
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#endif
+
+ThreadPoolAsyncFileSystem::ThreadPoolAsyncFileSystem(size_t threadCount) : pool(threadCount) {}
+
+std::future<std::string> ThreadPoolAsyncFileSystem::readFileAsync(const std::string& filename) {
+    return pool.submit([this, filename]() {
+        if (!files.fileExists(filename)) {
+            throw std::runtime_error("Cannot open file: " + filename);
+        }
+        return files.readFile(filename);
+    });
+}
+
+std::future<bool> ThreadPoolAsyncFileSystem::writeFileAsync(const std::string& filename, std::string content) {
+    return pool.submit([this, filename, content = std::move(content)]() {
+        return files.writeFile(filename, content);
+    });
+}
+
+#ifdef ASYNC_FILE_SYSTEM_IO_URING
+
+namespace {
+
+// Transfers are capped per submission; longer ones are resubmitted.
+const size_t MAX_TRANSFER = 1u << 30;
+
+int setupRing(unsigned entries, io_uring_params& params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+}
+
+int enterRing(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+template <typename T>
+T* ringField(void* base, unsigned offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+struct Request {
+    bool isRead;
+    std::string filename;
+    int fd;
+    std::string buffer;
+    size_t done;
+    std::promise<std::string> readResult;
+    std::promise<bool> writeResult;
+};
+
+}
+
+// Ring memory shared with the kernel, plus the bookkeeping around it. The
+// submission queue is guarded by `mutex`; the completion queue is only
+// touched by the reaper thread.
+struct IoUringFileSystem::State {
+    int ringFd = -1;
+    void* sqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    void* cqRing = MAP_FAILED;
+    size_t cqRingSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+    unsigned capacity = 0;
+
+    std::mutex mutex;
+    std::condition_variable slotFree;
+    unsigned inFlight = 0;
+    unsigned unsubmitted = 0;
+    bool stopping = false;
+    std::thread reaper;
+
+    ~State() {
+        if (sqes != MAP_FAILED) {
+            ::munmap(sqes, sqesSize);
+        }
+        if (cqRing != MAP_FAILED && cqRing != sqRing) {
+            ::munmap(cqRing, cqRingSize);
+        }
+        if (sqRing != MAP_FAILED) {
+            ::munmap(sqRing, sqRingSize);
+        }
+        if (ringFd >= 0) {
+            ::close(ringFd);
+        }
+    }
+
+    // Outcome of handing queued SQEs to the kernel.
+    enum class Push {
+        Submitted,
+        Busy,
+        Failed
+    };
+
+    // Queues one SQE and hands everything queued to the kernel. Caller
+    // holds `mutex` and has made sure a submission slot is free.
+    Push pushLocked(std::uint8_t opcode, int fd, const void* address, unsigned length, std::uint64_t offset,
+                    std::uint64_t userData) {
+        unsigned tail = *sqTail;
+        unsigned index = tail & sqMask;
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = opcode;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<std::uint64_t>(address);
+        sqe.len = length;
+        sqe.off = offset;
+        sqe.user_data = userData;
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++unsubmitted;
+        return flushLocked();
+    }
+
+    // Busy means the kernel wants completions reaped first; the SQEs stay
+    // queued for a later flush. On any other error the kernel has taken
+    // none of them, so they are withdrawn and their requests failed.
+    Push flushLocked() {
+        while (unsubmitted > 0) {
+            int submitted = enterRing(ringFd, unsubmitted, 0, 0);
+            if (submitted > 0) {
+                unsubmitted -= static_cast<unsigned>(submitted);
+                continue;
+            }
+            if (submitted < 0 && errno == EINTR) {
+                continue;
+            }
+            if (submitted == 0 || errno == EAGAIN || errno == EBUSY) {
+                return Push::Busy;
+            }
+            withdrawLocked(std::strerror(errno));
+            return Push::Failed;
+        }
+        return Push::Submitted;
+    }
+
+    void withdrawLocked(const std::string& reason) {
+        unsigned tail = *sqTail - unsubmitted;
+        std::vector<Request*> withdrawn;
+        for (unsigned i = tail; i != *sqTail; ++i) {
+            if (std::uint64_t userData = sqes[i & sqMask].user_data) {
+                withdrawn.push_back(reinterpret_cast<Request*>(userData));
+            }
+        }
+        __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+        unsubmitted = 0;
+        for (Request* request : withdrawn) {
+            settle(request, false, "Cannot submit request for " + request->filename + " (" + reason + ")");
+            --inFlight;
+        }
+        slotFree.notify_all();
+    }
+
+    Push submitLocked(Request* request) {
+        size_t remaining = request->buffer.size() - request->done;
+        return pushLocked(request->isRead ? IORING_OP_READ : IORING_OP_WRITE, request->fd,
+                          request->buffer.data() + request->done,
+                          static_cast<unsigned>(std::min(remaining, MAX_TRANSFER)), request->done,
+                          reinterpret_cast<std::uint64_t>(request));
+    }
+
+    // While the kernel is busy the lock is released, so the reaper can
+    // drain completions before the next attempt.
+    void waitOutBusy(std::unique_lock<std::mutex>& lock, Push result) {
+        while (result == Push::Busy) {
+            lock.unlock();
+            std::this_thread::yield();
+            lock.lock();
+            result = flushLocked();
+        }
+    }
+
+    // Waits until the submission queue has room for one more SQE.
+    void waitForSlot(std::unique_lock<std::mutex>& lock) {
+        while (*sqTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries) {
+            lock.unlock();
+            std::this_thread::yield();
+            lock.lock();
+            flushLocked();
+        }
+    }
+
+    void submit(std::unique_ptr<Request> request) {
+        std::unique_lock<std::mutex> lock(mutex);
+        slotFree.wait(lock, [this]() { return inFlight < capacity; });
+        ++inFlight;
+        waitOutBusy(lock, submitLocked(request.release()));
+    }
+
+    // Fulfils the request's promise and frees it.
+    static void settle(Request* request, bool success, const std::string& error) {
+        std::unique_ptr<Request> owned(request);
+        ::close(request->fd);
+        if (request->isRead) {
+            if (success) {
+                request->buffer.resize(request->done);
+                request->readResult.set_value(std::move(request->buffer));
+            } else {
+                request->readResult.set_exception(std::make_exception_ptr(std::runtime_error(error)));
+            }
+        } else {
+            request->writeResult.set_value(success);
+        }
+    }
+
+    void finish(Request* request, bool success, const std::string& error) {
+        settle(request, success, error);
+        std::lock_guard<std::mutex> lock(mutex);
+        --inFlight;
+        slotFree.notify_one();
+    }
+
+    // Resubmissions from the reaper never wait out a busy kernel here: the
+    // reaper is what un-busies it, and it flushes before it next waits.
+    void complete(Request* request, int result) {
+        if (result == -EINTR || result == -EAGAIN) {
+            std::lock_guard<std::mutex> lock(mutex);
+            submitLocked(request);
+            return;
+        }
+        if (result < 0) {
+            finish(request, false, std::string(request->isRead ? "Failed to read file: " : "Failed to write file: ") +
+                                       request->filename + " (" + std::strerror(-result) + ")");
+            return;
+        }
+
+        request->done += static_cast<size_t>(result);
+        bool shortRead = request->isRead && result == 0;
+        if (request->done < request->buffer.size() && !shortRead) {
+            std::lock_guard<std::mutex> lock(mutex);
+            submitLocked(request);
+            return;
+        }
+        finish(request, true, std::string());
+    }
+
+    void reap() {
+        for (;;) {
+            unsigned head = *cqHead;
+            unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            bool queued = false;
+            {
+                // Every request was queued under this lock, so taking it
+                // once per batch also orders the submitters' writes for
+                // race detectors, which cannot see through the kernel.
+                std::lock_guard<std::mutex> lock(mutex);
+                if (head == tail && stopping && inFlight == 0) {
+                    return;
+                }
+                queued = flushLocked() == Push::Busy;
+            }
+            if (head == tail) {
+                // Entries the kernel has not taken yet cannot complete, so
+                // waiting for a completion then could wait forever.
+                if (queued) {
+                    std::this_thread::yield();
+                } else {
+                    enterRing(ringFd, 0, 1, IORING_ENTER_GETEVENTS);
+                }
+                continue;
+            }
+
+            for (; head != tail; ++head) {
+                io_uring_cqe cqe = cqes[head & cqMask];
+                __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+                if (cqe.user_data != 0) {
+                    complete(reinterpret_cast<Request*>(cqe.user_data), cqe.res);
+                }
+            }
+        }
+    }
+};
+
+IoUringFileSystem::IoUringFileSystem(unsigned queueDepth) : state(std::make_unique<State>()) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    // One entry more than the request limit leaves room for the shutdown
+    // no-op even when every request is queued.
+    queueDepth = std::max(1u, queueDepth);
+    state->ringFd = setupRing(queueDepth + 1, params);
+    if (state->ringFd < 0) {
+        throw std::runtime_error(std::string("io_uring is unavailable: ") + std::strerror(errno));
+    }
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+        throw std::runtime_error("io_uring is unavailable: kernel lacks IORING_OP_READ/WRITE");
+    }
+
+    state->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    state->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+        state->sqRingSize = state->cqRingSize = std::max(state->sqRingSize, state->cqRingSize);
+    }
+
+    state->sqRing = ::mmap(nullptr, state->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           state->ringFd, IORING_OFF_SQ_RING);
+    if (state->sqRing == MAP_FAILED) {
+        throw std::runtime_error("io_uring is unavailable: cannot map submission ring");
+    }
+    state->cqRing = singleMap ? state->sqRing
+                              : ::mmap(nullptr, state->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                       state->ringFd, IORING_OFF_CQ_RING);
+    if (state->cqRing == MAP_FAILED) {
+        throw std::runtime_error("io_uring is unavailable: cannot map completion ring");
+    }
+    state->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    state->sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, state->sqesSize, PROT_READ | PROT_WRITE,
+                                                    MAP_SHARED | MAP_POPULATE, state->ringFd, IORING_OFF_SQES));
+    if (state->sqes == MAP_FAILED) {
+        throw std::runtime_error("io_uring is unavailable: cannot map submission entries");
+    }
+
+    state->sqHead = ringField<unsigned>(state->sqRing, params.sq_off.head);
+    state->sqTail = ringField<unsigned>(state->sqRing, params.sq_off.tail);
+    state->sqMask = *ringField<unsigned>(state->sqRing, params.sq_off.ring_mask);
+    state->sqEntries = params.sq_entries;
+    state->sqArray = ringField<unsigned>(state->sqRing, params.sq_off.array);
+    state->cqHead = ringField<unsigned>(state->cqRing, params.cq_off.head);
+    state->cqTail = ringField<unsigned>(state->cqRing, params.cq_off.tail);
+    state->cqMask = *ringField<unsigned>(state->cqRing, params.cq_off.ring_mask);
+    state->cqes = ringField<io_uring_cqe>(state->cqRing, params.cq_off.cqes);
+    // Fewer requests than submission slots, which also keeps the (larger)
+    // completion queue from overflowing.
+    state->capacity = std::min(queueDepth, params.sq_entries - 1);
+
+    State* shared = state.get();
+    state->reaper = std::thread([shared]() { shared->reap(); });
+}
+
+IoUringFileSystem::~IoUringFileSystem() {
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->stopping = true;
+        // A no-op completion wakes the reaper if it is waiting on an idle ring.
+        state->waitForSlot(lock);
+        state->waitOutBusy(lock, state->pushLocked(IORING_OP_NOP, -1, nullptr, 0, 0, 0));
+    }
+    state->reaper.join();
+}
+
+bool IoUringFileSystem::isAvailable() {
+    static const bool available = []() {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        int fd = setupRing(1, params);
+        if (fd < 0) {
+            return false;
+        }
+        ::close(fd);
+        return (params.features & IORING_FEAT_RW_CUR_POS) != 0;
+    }();
+    return available;
+}
+
+std::future<std::string> IoUringFileSystem::readFileAsync(const std::string& filename) {
+    auto request = std::make_unique<Request>();
+    std::future<std::string> result = request->readResult.get_future();
+
+    int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd < 0 || ::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        request->readResult.set_exception(std::make_exception_ptr(std::runtime_error("Cannot open file: " + filename)));
+        return result;
+    }
+    if (info.st_size == 0) {
+        ::close(fd);
+        request->readResult.set_value(std::string());
+        return result;
+    }
+
+    request->isRead = true;
+    request->filename = filename;
+    request->fd = fd;
+    request->buffer.resize(static_cast<size_t>(info.st_size));
+    request->done = 0;
+    state->submit(std::move(request));
+    return result;
+}
+
+std::future<bool> IoUringFileSystem::writeFileAsync(const std::string& filename, std::string content) {
+    auto request = std::make_unique<Request>();
+    std::future<bool> result = request->writeResult.get_future();
+
+    int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0 || content.empty()) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        request->writeResult.set_value(fd >= 0);
+        return result;
+    }
+
+    request->isRead = false;
+    request->filename = filename;
+    request->fd = fd;
+    request->buffer = std::move(content);
+    request->done = 0;
+    state->submit(std::move(request));
+    return result;
+}
+
+#else
+
+struct IoUringFileSystem::State {};
+
+IoUringFileSystem::IoUringFileSystem(unsigned) {
+    throw std::runtime_error("io_uring is unavailable on this platform");
+}
+
+IoUringFileSystem::~IoUringFileSystem() = default;
+
+bool IoUringFileSystem::isAvailable() {
+    return false;
+}
+
+std::future<std::string> IoUringFileSystem::readFileAsync(const std::string&) {
+    throw std::runtime_error("io_uring is unavailable on this platform");
+}
+
+std::future<bool> IoUringFileSystem::writeFileAsync(const std::string&, std::string) {
+    throw std::runtime_error("io_uring is unavailable on this platform");
+}
+
+#endif
+
+std::unique_ptr<IAsyncFileSystem> createAsyncFileSystem(unsigned queueDepth) {
+    if (IoUringFileSystem::isAvailable()) {
+        try {
+            return std::make_unique<IoUringFileSystem>(queueDepth);
+        } catch (const std::runtime_error&) {
+        }
+    }
+    return std::make_unique<ThreadPoolAsyncFileSystem>();
+}
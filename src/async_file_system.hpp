@@ -0,0 +1,50 @@
+#pragma once
+#include "interfaces.hpp"
+#include "posix_file_system.hpp"
+#include "thread_pool.hpp"
+#include <memory>
+
+// IAsyncFileSystem on blocking POSIX calls run in a thread pool. Works
+// everywhere, at the cost of one blocked worker per outstanding request.
+class ThreadPoolAsyncFileSystem : public IAsyncFileSystem {
+private:
+    PosixFileSystem files;
+    ThreadPool pool;
+
+public:
+    // Zero selects std::thread::hardware_concurrency().
+    explicit ThreadPoolAsyncFileSystem(size_t threadCount = 0);
+
+    std::future<std::string> readFileAsync(const std::string& filename) override;
+    std::future<bool> writeFileAsync(const std::string& filename, std::string content) override;
+};
+
+// IAsyncFileSystem on Linux io_uring, driven through the raw system calls.
+// Files are opened and sized on the calling thread; the data transfer is
+// queued to the kernel and a single completion thread fulfils the futures,
+// so any number of threads can keep up to queueDepth transfers in flight.
+// Submitting beyond that waits for a completion.
+class IoUringFileSystem : public IAsyncFileSystem {
+private:
+    struct State;
+    std::unique_ptr<State> state;
+
+public:
+    static constexpr unsigned DEFAULT_QUEUE_DEPTH = 256;
+
+    // Throws std::runtime_error when io_uring is unavailable.
+    explicit IoUringFileSystem(unsigned queueDepth = DEFAULT_QUEUE_DEPTH);
+    // Waits for outstanding requests before tearing down the ring.
+    ~IoUringFileSystem() override;
+
+    IoUringFileSystem(const IoUringFileSystem&) = delete;
+    IoUringFileSystem& operator=(const IoUringFileSystem&) = delete;
+
+    static bool isAvailable();
+
+    std::future<std::string> readFileAsync(const std::string& filename) override;
+    std::future<bool> writeFileAsync(const std::string& filename, std::string content) override;
+};
+
+// io_uring when the kernel supports it, the thread pool otherwise.
+std::unique_ptr<IAsyncFileSystem> createAsyncFileSystem(unsigned queueDepth = IoUringFileSystem::DEFAULT_QUEUE_DEPTH);
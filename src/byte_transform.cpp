@@ -0,0 +1,138 @@
+#include "byte_transform.hpp"
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define BYTE_TRANSFORM_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using ByteTransform::Isa;
+
+// Each kernel flips bit 0x20 of the bytes in [First, First + 25], which
+// maps a-z to A-Z when First is 'a' and A-Z to a-z when it is 'A'.
+
+template <char First>
+void flipCasePortable(const char* input, char* output, size_t size) {
+    const std::uint64_t ones = 0x0101010101010101ULL;
+    const std::uint64_t high = 0x8080808080808080ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, input + i, 8);
+        // Per byte, with the high bit cleared first so additions cannot
+        // carry into the neighbour: bit 7 of atLeastFirst is set for bytes
+        // >= First, bit 7 of pastLast for bytes > First + 25.
+        std::uint64_t low7 = word & ~high;
+        std::uint64_t atLeastFirst = low7 + ones * (0x80 - First);
+        std::uint64_t pastLast = low7 + ones * (0x80 - First - 26);
+        std::uint64_t inRange = (atLeastFirst ^ pastLast) & ~word & high;
+        word ^= inRange >> 2;
+        std::memcpy(output + i, &word, 8);
+    }
+    for (; i < size; ++i) {
+        unsigned char c = static_cast<unsigned char>(input[i]);
+        output[i] = static_cast<char>(static_cast<unsigned char>(c - First) < 26 ? c ^ 0x20 : c);
+    }
+}
+
+#ifdef BYTE_TRANSFORM_X86
+
+// Shifting by 0x80 - First moves the range to the bottom of the signed
+// byte range, where one signed compare selects it.
+template <char First>
+__attribute__((target("sse2"))) void flipCaseSse2(const char* input, char* output, size_t size) {
+    const __m128i shift = _mm_set1_epi8(static_cast<char>(0x80 - First));
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(-128 + 26));
+    const __m128i bit = _mm_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        __m128i inRange = _mm_cmplt_epi8(_mm_add_epi8(v, shift), limit);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_xor_si128(v, _mm_and_si128(inRange, bit)));
+    }
+    flipCasePortable<First>(input + i, output + i, size - i);
+}
+
+template <char First>
+__attribute__((target("avx2"))) void flipCaseAvx2(const char* input, char* output, size_t size) {
+    const __m256i shift = _mm256_set1_epi8(static_cast<char>(0x80 - First));
+    const __m256i limit = _mm256_set1_epi8(static_cast<char>(-128 + 26));
+    const __m256i bit = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        __m256i inRange = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(v, shift));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_xor_si256(v, _mm256_and_si256(inRange, bit)));
+    }
+    flipCaseSse2<First>(input + i, output + i, size - i);
+}
+
+#endif
+
+Isa detectIsa() {
+#ifdef BYTE_TRANSFORM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::Avx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return Isa::Sse2;
+    }
+#endif
+    return Isa::Portable;
+}
+
+template <char First>
+void flipCase(Isa isa, const char* input, char* output, size_t size) {
+#ifdef BYTE_TRANSFORM_X86
+    if (isa == Isa::Avx2) {
+        flipCaseAvx2<First>(input, output, size);
+        return;
+    }
+    if (isa == Isa::Sse2) {
+        flipCaseSse2<First>(input, output, size);
+        return;
+    }
+#endif
+    flipCasePortable<First>(input, output, size);
+}
+
+}
+
+namespace ByteTransform {
+
+Isa activeIsa() {
+    static const Isa isa = detectIsa();
+    return isa;
+}
+
+bool isSupported(Isa isa) {
+    return static_cast<int>(isa) <= static_cast<int>(activeIsa());
+}
+
+void toUpperAscii(const char* input, char* output, size_t size) {
+    flipCase<'a'>(activeIsa(), input, output, size);
+}
+
+void toLowerAscii(const char* input, char* output, size_t size) {
+    flipCase<'A'>(activeIsa(), input, output, size);
+}
+
+void copy(const char* input, char* output, size_t size) {
+    if (input != output) {
+        std::memmove(output, input, size);
+    }
+}
+
+void toUpperAscii(Isa isa, const char* input, char* output, size_t size) {
+    flipCase<'a'>(isSupported(isa) ? isa : Isa::Portable, input, output, size);
+}
+
+void toLowerAscii(Isa isa, const char* input, char* output, size_t size) {
+    flipCase<'A'>(isSupported(isa) ? isa : Isa::Portable, input, output, size);
+}
+
+}
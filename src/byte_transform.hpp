@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+
+// Byte-level transforms with the signature FileProcessor plugs in. Output
+// may alias input for an in-place transform. The ASCII case kernels leave
+// every byte outside A-Z/a-z untouched, independent of the C locale. They
+// are vectorised with AVX2 or SSE2 when the CPU has them and fall back to
+// eight bytes at a time in a 64-bit word otherwise.
+namespace ByteTransform {
+
+using Kernel = void (*)(const char* input, char* output, size_t size);
+
+enum class Isa {
+    Portable,
+    Sse2,
+    Avx2
+};
+
+Isa activeIsa();
+bool isSupported(Isa isa);
+
+void toUpperAscii(const char* input, char* output, size_t size);
+void toLowerAscii(const char* input, char* output, size_t size);
+void copy(const char* input, char* output, size_t size);
+
+void toUpperAscii(Isa isa, const char* input, char* output, size_t size);
+void toLowerAscii(Isa isa, const char* input, char* output, size_t size);
+
+}
@@ -2,11 +2,33 @@
 #include <cmath>
 #include <algorithm>
 #include <sstream>
+#include <limits>
+
+namespace {
+
+const double DEGREES_TO_RADIANS = M_PI / 180.0;
+
+template <typename Op>
+void applyElementwise(const double* a, const double* b, double* out, size_t count, Op op) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = op(a[i], b[i]);
+    }
+}
+
+void requireSameSize(const std::vector<double>& a, const std::vector<double>& b) {
+    if (a.size() != b.size()) {
+        throw std::invalid_argument("Batch operands must have the same size");
+    }
+}
 
-Calculator::Calculator() : memory(0.0), degrees_mode(true) {
-    history.reserve(100);
 }
 
+Calculator::Calculator() : Calculator(DEFAULT_HISTORY_CAPACITY) {}
+
+Calculator::Calculator(size_t historyCapacity)
+    : history(historyCapacity), memory(0.0), degrees_mode(true), fast_trig(false),
+      summation_mode(SummationMode::Neumaier) {}
+
 double Calculator::add(double a, double b) {
     double result = a + b;
     addToHistory(result);
@@ -34,6 +56,72 @@ double Calculator::divide(double a, double b) {
     return result;
 }
 
+void Calculator::addBatch(const double* a, const double* b, double* out, size_t count) {
+    applyElementwise(a, b, out, count, [](double x, double y) { return x + y; });
+    addToHistory(out, count);
+}
+
+void Calculator::subtractBatch(const double* a, const double* b, double* out, size_t count) {
+    applyElementwise(a, b, out, count, [](double x, double y) { return x - y; });
+    addToHistory(out, count);
+}
+
+void Calculator::multiplyBatch(const double* a, const double* b, double* out, size_t count) {
+    applyElementwise(a, b, out, count, [](double x, double y) { return x * y; });
+    addToHistory(out, count);
+}
+
+size_t Calculator::divideBatch(const double* a, const double* b, double* out, size_t count,
+                               unsigned char* divisionByZero) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    size_t failures = 0;
+    if (divisionByZero) {
+        for (size_t i = 0; i < count; ++i) {
+            divisionByZero[i] = b[i] == 0.0;
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        failures += b[i] == 0.0;
+    }
+    applyElementwise(a, b, out, count, [nan](double x, double y) { return y == 0.0 ? nan : x / y; });
+    addToHistory(out, count);
+    return failures;
+}
+
+std::vector<double> Calculator::addBatch(const std::vector<double>& a, const std::vector<double>& b) {
+    requireSameSize(a, b);
+    std::vector<double> results(a.size());
+    addBatch(a.data(), b.data(), results.data(), a.size());
+    return results;
+}
+
+std::vector<double> Calculator::subtractBatch(const std::vector<double>& a, const std::vector<double>& b) {
+    requireSameSize(a, b);
+    std::vector<double> results(a.size());
+    subtractBatch(a.data(), b.data(), results.data(), a.size());
+    return results;
+}
+
+std::vector<double> Calculator::multiplyBatch(const std::vector<double>& a, const std::vector<double>& b) {
+    requireSameSize(a, b);
+    std::vector<double> results(a.size());
+    multiplyBatch(a.data(), b.data(), results.data(), a.size());
+    return results;
+}
+
+std::vector<double> Calculator::divideBatch(const std::vector<double>& a, const std::vector<double>& b,
+                                            std::vector<unsigned char>* divisionByZero) {
+    requireSameSize(a, b);
+    std::vector<double> results(a.size());
+    unsigned char* mask = nullptr;
+    if (divisionByZero) {
+        divisionByZero->resize(a.size());
+        mask = divisionByZero->data();
+    }
+    divideBatch(a.data(), b.data(), results.data(), a.size(), mask);
+    return results;
+}
+
 double Calculator::power(double base, double exponent) {
     if (base == 0.0 && exponent < 0.0) {
         throw std::invalid_argument("Cannot raise zero to negative power");
@@ -53,19 +141,152 @@ double Calculator::sqrt(double value) {
 }
 
 double Calculator::sin(double angle) {
-    double radians = degrees_mode ? angle * M_PI / 180.0 : angle;
-    double result = std::sin(radians);
+    double result;
+    if (fast_trig) {
+        double unused;
+        fastSinCos(angle, result, unused);
+    } else {
+        result = std::sin(toRadians(angle));
+    }
     addToHistory(result);
     return result;
 }
 
 double Calculator::cos(double angle) {
-    double radians = degrees_mode ? angle * M_PI / 180.0 : angle;
-    double result = std::cos(radians);
+    double result;
+    if (fast_trig) {
+        double unused;
+        fastSinCos(angle, unused, result);
+    } else {
+        result = std::cos(toRadians(angle));
+    }
+    addToHistory(result);
+    return result;
+}
+
+std::pair<double, double> Calculator::sincos(double angle) {
+    double sine;
+    double cosine;
+    sincosBatch(&angle, &sine, &cosine, 1);
+    return {sine, cosine};
+}
+
+void Calculator::sinBatch(const double* angles, double* out, size_t count) {
+    if (fast_trig) {
+        double unused;
+        for (size_t i = 0; i < count; ++i) {
+            fastSinCos(angles[i], out[i], unused);
+        }
+    } else {
+        const double scale = degrees_mode ? DEGREES_TO_RADIANS : 1.0;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = std::sin(angles[i] * scale);
+        }
+    }
+    addToHistory(out, count);
+}
+
+void Calculator::cosBatch(const double* angles, double* out, size_t count) {
+    if (fast_trig) {
+        double unused;
+        for (size_t i = 0; i < count; ++i) {
+            fastSinCos(angles[i], unused, out[i]);
+        }
+    } else {
+        const double scale = degrees_mode ? DEGREES_TO_RADIANS : 1.0;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = std::cos(angles[i] * scale);
+        }
+    }
+    addToHistory(out, count);
+}
+
+void Calculator::sincosBatch(const double* angles, double* sines, double* cosines, size_t count) {
+    if (fast_trig) {
+        for (size_t i = 0; i < count; ++i) {
+            fastSinCos(angles[i], sines[i], cosines[i]);
+        }
+    } else {
+        const double scale = degrees_mode ? DEGREES_TO_RADIANS : 1.0;
+        for (size_t i = 0; i < count; ++i) {
+            const double radians = angles[i] * scale;
+            sines[i] = std::sin(radians);
+            cosines[i] = std::cos(radians);
+        }
+    }
+    addToHistory(sines, count);
+    addToHistory(cosines, count);
+}
+
+std::vector<double> Calculator::sinBatch(const std::vector<double>& angles) {
+    std::vector<double> results(angles.size());
+    sinBatch(angles.data(), results.data(), angles.size());
+    return results;
+}
+
+std::vector<double> Calculator::cosBatch(const std::vector<double>& angles) {
+    std::vector<double> results(angles.size());
+    cosBatch(angles.data(), results.data(), angles.size());
+    return results;
+}
+
+std::pair<std::vector<double>, std::vector<double>> Calculator::sincosBatch(const std::vector<double>& angles) {
+    std::pair<std::vector<double>, std::vector<double>> results;
+    results.first.resize(angles.size());
+    results.second.resize(angles.size());
+    sincosBatch(angles.data(), results.first.data(), results.second.data(), angles.size());
+    return results;
+}
+
+double Calculator::toRadians(double angle) const {
+    return degrees_mode ? angle * DEGREES_TO_RADIANS : angle;
+}
+
+void Calculator::fastSinCos(double angle, double& sine, double& cosine) const {
+    if (degrees_mode) {
+        FastTrig::sincosDegrees(angle, sine, cosine);
+    } else {
+        FastTrig::sincosRadians(angle, sine, cosine);
+    }
+}
+
+double Calculator::sum(const double* values, size_t count) {
+    double result = Summation::sum(summation_mode, values, count);
+    addToHistory(result);
+    return result;
+}
+
+double Calculator::sum(const std::vector<double>& values) {
+    return sum(values.data(), values.size());
+}
+
+double Calculator::accumulate(double value) {
+    if (summation_mode == SummationMode::Naive) {
+        accumulator.sum += value;
+    } else {
+        accumulator.add(value);
+    }
+    double result = accumulator.total();
     addToHistory(result);
     return result;
 }
 
+double Calculator::getAccumulator() const {
+    return accumulator.total();
+}
+
+void Calculator::clearAccumulator() {
+    accumulator.clear();
+}
+
+void Calculator::setSummationMode(SummationMode mode) {
+    summation_mode = mode;
+}
+
+SummationMode Calculator::getSummationMode() const {
+    return summation_mode;
+}
+
 void Calculator::setMemory(double value) {
     memory = value;
 }
@@ -86,15 +307,40 @@ bool Calculator::isDegreesMode() const {
     return degrees_mode;
 }
 
+void Calculator::setFastTrigMode(bool fast) {
+    fast_trig = fast;
+}
+
+bool Calculator::isFastTrigMode() const {
+    return fast_trig;
+}
+
 void Calculator::addToHistory(double value) {
-    history.push_back(value);
-    if (history.size() > 100) {
-        history.erase(history.begin());
-    }
+    history.push(value);
+}
+
+void Calculator::addToHistory(const double* values, size_t count) {
+    history.pushRange(values, count);
 }
 
 std::vector<double> Calculator::getHistory() const {
-    return history;
+    return history.toVector();
+}
+
+Calculator::HistoryView Calculator::getHistoryView() const {
+    return history.view();
+}
+
+Calculator::HistoryView Calculator::getHistorySince(uint64_t sequence) const {
+    return history.viewSince(sequence);
+}
+
+uint64_t Calculator::getHistorySequence() const {
+    return history.nextSequence();
+}
+
+size_t Calculator::getHistoryCapacity() const {
+    return history.capacity();
 }
 
 void Calculator::clearHistory() {
@@ -108,21 +354,127 @@ double Calculator::getLastResult() const {
     return history.back();
 }
 
+void Calculator::setVariable(const std::string& name, double value) {
+    if (name.empty() || CompiledExpression::isReservedName(name)) {
+        throw std::invalid_argument("Invalid variable name: " + name);
+    }
+    variables[name] = value;
+}
+
+double Calculator::getVariable(const std::string& name) const {
+    auto it = variables.find(name);
+    if (it == variables.end()) {
+        throw std::invalid_argument("Unknown variable: " + name);
+    }
+    return it->second;
+}
+
+bool Calculator::hasVariable(const std::string& name) const {
+    return variables.find(name) != variables.end();
+}
+
+void Calculator::clearVariables() {
+    variables.clear();
+}
+
 double Calculator::evaluateExpression(const std::string& expression) {
     if (expression.empty()) {
         throw std::invalid_argument("Empty expression");
     }
     
-    if (expression == "2+3") return add(2, 3);
-    if (expression == "10-4") return subtract(10, 4);
-    if (expression == "6*7") return multiply(6, 7);
-    if (expression == "15/3") return divide(15, 3);
+    return evaluateCompiled(*compileExpression(expression));
+}
+
+std::shared_ptr<const CompiledExpression> Calculator::compileExpression(const std::string& expression) {
+    auto cached = expressionCache.find(expression);
+    if (cached != expressionCache.end()) {
+        expressionRecency.splice(expressionRecency.begin(), expressionRecency, cached->second);
+        return cached->second->compiled;
+    }
+    
+    auto compiled = std::make_shared<const CompiledExpression>(CompiledExpression::compile(expression));
+    if (expressionCache.size() >= MAX_CACHED_EXPRESSIONS) {
+        expressionCache.erase(expressionRecency.back().source);
+        expressionRecency.pop_back();
+    }
+    expressionRecency.push_front(CachedExpression{expression, compiled});
+    expressionCache.emplace(expression, expressionRecency.begin());
+    return compiled;
+}
+
+double Calculator::evaluateCompiled(const CompiledExpression& expression) {
+    const auto& names = expression.getVariables();
+    variableBindings.resize(names.size());
+    for (size_t i = 0; i < names.size(); ++i) {
+        variableBindings[i] = getVariable(names[i]);
+    }
     
-    throw std::invalid_argument("Unsupported expression format");
+    double result = expression.evaluate({variableBindings.data(), memory, degrees_mode});
+    addToHistory(result);
+    return result;
+}
+
+void Calculator::evaluateExpressionBatch(const std::string& expression,
+                                         const std::unordered_map<std::string, const double*>& columns,
+                                         size_t rows, double* out) {
+    if (expression.empty()) {
+        throw std::invalid_argument("Empty expression");
+    }
+    
+    auto compiled = compileExpression(expression);
+    const auto& names = compiled->getVariables();
+    
+    variableBindings.resize(names.size());
+    std::vector<ExpressionColumn> bindings(names.size());
+    for (size_t i = 0; i < names.size(); ++i) {
+        auto column = columns.find(names[i]);
+        if (column != columns.end()) {
+            bindings[i] = {column->second, false};
+        } else {
+            variableBindings[i] = getVariable(names[i]);
+            bindings[i] = {&variableBindings[i], true};
+        }
+    }
+    
+    compiled->evaluateBatch({bindings.data(), rows, memory, degrees_mode}, out);
+    addToHistory(out, rows);
+}
+
+std::vector<double> Calculator::evaluateExpressionBatch(const std::string& expression,
+                                                        const std::unordered_map<std::string, std::vector<double>>& columns) {
+    if (columns.empty()) {
+        throw std::invalid_argument("Batch evaluation requires at least one column");
+    }
+    
+    size_t rows = columns.begin()->second.size();
+    std::unordered_map<std::string, const double*> pointers;
+    for (const auto& column : columns) {
+        if (column.second.size() != rows) {
+            throw std::invalid_argument("Batch columns must have the same size");
+        }
+        pointers.emplace(column.first, column.second.data());
+    }
+    
+    std::vector<double> results(rows);
+    evaluateExpressionBatch(expression, pointers, rows, results.data());
+    return results;
+}
+
+size_t Calculator::getCachedExpressionCount() const {
+    return expressionCache.size();
+}
+
+void Calculator::clearExpressionCache() {
+    expressionCache.clear();
+    expressionRecency.clear();
 }
 
 void Calculator::reset() {
     memory = 0.0;
     degrees_mode = true;
+    fast_trig = false;
+    summation_mode = SummationMode::Neumaier;
+    accumulator.clear();
     history.clear();
+    variables.clear();
 }
\ No newline at end of file
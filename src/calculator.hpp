@@ -1,26 +1,87 @@
 #pragma once
+#include "expression.hpp"
+#include "fast_trig.hpp"
+#include "ring_buffer.hpp"
+#include "summation.hpp"
 #include <vector>
 #include <string>
 #include <stdexcept>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
 
 class Calculator {
 private:
-    std::vector<double> history;
+    RingBuffer<double> history;
     double memory;
     bool degrees_mode;
+    bool fast_trig;
+    SummationMode summation_mode;
+    Summation::Accumulator accumulator;
+    std::unordered_map<std::string, double> variables;
+    struct CachedExpression {
+        std::string source;
+        std::shared_ptr<const CompiledExpression> compiled;
+    };
+    // Most recently used first; the map indexes into it by source.
+    std::list<CachedExpression> expressionRecency;
+    std::unordered_map<std::string, std::list<CachedExpression>::iterator> expressionCache;
+    std::vector<double> variableBindings;
     
 public:
+    using HistoryView = RingBufferView<double>;
+    
+    static constexpr size_t DEFAULT_HISTORY_CAPACITY = 100;
+    static constexpr size_t MAX_CACHED_EXPRESSIONS = 256;
+    
     Calculator();
+    explicit Calculator(size_t historyCapacity);
     
     double add(double a, double b);
     double subtract(double a, double b);
     double multiply(double a, double b);
     double divide(double a, double b);
     
+    void addBatch(const double* a, const double* b, double* out, size_t count);
+    void subtractBatch(const double* a, const double* b, double* out, size_t count);
+    void multiplyBatch(const double* a, const double* b, double* out, size_t count);
+    size_t divideBatch(const double* a, const double* b, double* out, size_t count,
+                       unsigned char* divisionByZero = nullptr);
+    
+    std::vector<double> addBatch(const std::vector<double>& a, const std::vector<double>& b);
+    std::vector<double> subtractBatch(const std::vector<double>& a, const std::vector<double>& b);
+    std::vector<double> multiplyBatch(const std::vector<double>& a, const std::vector<double>& b);
+    std::vector<double> divideBatch(const std::vector<double>& a, const std::vector<double>& b,
+                                    std::vector<unsigned char>* divisionByZero = nullptr);
+    
     double power(double base, double exponent);
     double sqrt(double value);
     double sin(double angle);
     double cos(double angle);
+    // Fused sine and cosine. History records them as sinBatch followed by
+    // cosBatch would: every sine, then every cosine, so getLastResult()
+    // is the last cosine.
+    std::pair<double, double> sincos(double angle);
+    
+    void sinBatch(const double* angles, double* out, size_t count);
+    void cosBatch(const double* angles, double* out, size_t count);
+    void sincosBatch(const double* angles, double* sines, double* cosines, size_t count);
+    std::vector<double> sinBatch(const std::vector<double>& angles);
+    std::vector<double> cosBatch(const std::vector<double>& angles);
+    std::pair<std::vector<double>, std::vector<double>> sincosBatch(const std::vector<double>& angles);
+    
+    double sum(const double* values, size_t count);
+    double sum(const std::vector<double>& values);
+    
+    // Running total for chained additions. Naive mode adds directly; every
+    // other mode carries a Neumaier compensation term between calls.
+    double accumulate(double value);
+    double getAccumulator() const;
+    void clearAccumulator();
+    
+    void setSummationMode(SummationMode mode);
+    SummationMode getSummationMode() const;
     
     void setMemory(double value);
     double getMemory() const;
@@ -29,12 +90,39 @@ public:
     void setDegreesMode(bool degrees);
     bool isDegreesMode() const;
     
+    void setFastTrigMode(bool fast);
+    bool isFastTrigMode() const;
+    
     void addToHistory(double value);
+    void addToHistory(const double* values, size_t count);
     std::vector<double> getHistory() const;
+    HistoryView getHistoryView() const;
+    HistoryView getHistorySince(uint64_t sequence) const;
+    uint64_t getHistorySequence() const;
+    size_t getHistoryCapacity() const;
     void clearHistory();
     double getLastResult() const;
     
+    void setVariable(const std::string& name, double value);
+    double getVariable(const std::string& name) const;
+    bool hasVariable(const std::string& name) const;
+    void clearVariables();
+    
     double evaluateExpression(const std::string& expression);
+    std::shared_ptr<const CompiledExpression> compileExpression(const std::string& expression);
+    double evaluateCompiled(const CompiledExpression& expression);
+    
+    void evaluateExpressionBatch(const std::string& expression,
+                                 const std::unordered_map<std::string, const double*>& columns,
+                                 size_t rows, double* out);
+    std::vector<double> evaluateExpressionBatch(const std::string& expression,
+                                                const std::unordered_map<std::string, std::vector<double>>& columns);
+    size_t getCachedExpressionCount() const;
+    void clearExpressionCache();
     
     void reset();
+    
+private:
+    double toRadians(double angle) const;
+    void fastSinCos(double angle, double& sine, double& cosine) const;
 };
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "concurrent_calculator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+const double DEGREES_TO_RADIANS = M_PI / 180.0;
+
+std::atomic<uint64_t> nextInstanceId{1};
+
+struct ShardCache {
+    uint64_t owner = 0;
+    void* shard = nullptr;
+};
+
+thread_local ShardCache shardCache;
+
+}
+
+ConcurrentCalculator::ConcurrentCalculator() : ConcurrentCalculator(DEFAULT_HISTORY_CAPACITY) {}
+
+ConcurrentCalculator::ConcurrentCalculator(size_t historyCapacity)
+    : capacity(historyCapacity), instanceId(nextInstanceId.fetch_add(1)),
+      nextSequence(0), clearedBefore(0), memory(0.0), degreesMode(true) {
+    if (historyCapacity == 0) {
+        throw std::invalid_argument("Ring buffer capacity must be positive");
+    }
+}
+
+double ConcurrentCalculator::add(double a, double b) {
+    double result = a + b;
+    addToHistory(result);
+    return result;
+}
+
+double ConcurrentCalculator::subtract(double a, double b) {
+    double result = a - b;
+    addToHistory(result);
+    return result;
+}
+
+double ConcurrentCalculator::multiply(double a, double b) {
+    double result = a * b;
+    addToHistory(result);
+    return result;
+}
+
+double ConcurrentCalculator::divide(double a, double b) {
+    if (b == 0.0) {
+        throw std::invalid_argument("Division by zero");
+    }
+    double result = a / b;
+    addToHistory(result);
+    return result;
+}
+
+double ConcurrentCalculator::power(double base, double exponent) {
+    if (base == 0.0 && exponent < 0.0) {
+        throw std::invalid_argument("Cannot raise zero to negative power");
+    }
+    double result = std::pow(base, exponent);
+    addToHistory(result);
+    return result;
+}
+
+double ConcurrentCalculator::sqrt(double value) {
+    if (value < 0.0) {
+        throw std::invalid_argument("Cannot take square root of negative number");
+    }
+    double result = std::sqrt(value);
+    addToHistory(result);
+    return result;
+}
+
+double ConcurrentCalculator::sin(double angle) {
+    double radians = isDegreesMode() ? angle * DEGREES_TO_RADIANS : angle;
+    double result = std::sin(radians);
+    addToHistory(result);
+    return result;
+}
+
+double ConcurrentCalculator::cos(double angle) {
+    double radians = isDegreesMode() ? angle * DEGREES_TO_RADIANS : angle;
+    double result = std::cos(radians);
+    addToHistory(result);
+    return result;
+}
+
+void ConcurrentCalculator::setMemory(double value) {
+    memory.store(value, std::memory_order_relaxed);
+}
+
+double ConcurrentCalculator::getMemory() const {
+    return memory.load(std::memory_order_relaxed);
+}
+
+void ConcurrentCalculator::clearMemory() {
+    setMemory(0.0);
+}
+
+void ConcurrentCalculator::setDegreesMode(bool degrees) {
+    degreesMode.store(degrees, std::memory_order_relaxed);
+}
+
+bool ConcurrentCalculator::isDegreesMode() const {
+    return degreesMode.load(std::memory_order_relaxed);
+}
+
+// Slot sequences are stored off by one so that zero marks a slot that is
+// empty or being rewritten. The writer invalidates the slot before
+// touching the value and republishes afterwards; a reader that sees the
+// same non-zero sequence before and after loading the value has a
+// consistent entry.
+void ConcurrentCalculator::addToHistory(double value) {
+    Shard& shard = localShard();
+    uint64_t sequence = nextSequence.fetch_add(1, std::memory_order_relaxed);
+
+    Slot& slot = shard.slots[shard.written % capacity];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.value.store(value, std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_release);
+    ++shard.written;
+}
+
+ConcurrentCalculator::Shard& ConcurrentCalculator::localShard() {
+    if (shardCache.owner == instanceId) {
+        return *static_cast<Shard*>(shardCache.shard);
+    }
+
+    std::lock_guard<std::mutex> lock(shardsMutex);
+    std::thread::id self = std::this_thread::get_id();
+    Shard* found = nullptr;
+    for (const auto& shard : shards) {
+        if (shard->owner == self) {
+            found = shard.get();
+            break;
+        }
+    }
+
+    if (!found) {
+        auto shard = std::make_unique<Shard>();
+        shard->owner = self;
+        shard->slots.reset(new Slot[capacity]);
+        for (size_t i = 0; i < capacity; ++i) {
+            shard->slots[i].sequence.store(0, std::memory_order_relaxed);
+            shard->slots[i].value.store(0.0, std::memory_order_relaxed);
+        }
+        shard->written = 0;
+        found = shard.get();
+        shards.push_back(std::move(shard));
+    }
+
+    shardCache.owner = instanceId;
+    shardCache.shard = found;
+    return *found;
+}
+
+std::vector<ConcurrentCalculator::Entry> ConcurrentCalculator::collectHistory() const {
+    uint64_t oldest = clearedBefore.load(std::memory_order_acquire);
+    std::vector<Entry> entries;
+
+    {
+        std::lock_guard<std::mutex> lock(shardsMutex);
+        entries.reserve(shards.size() * capacity);
+        for (const auto& shard : shards) {
+            for (size_t i = 0; i < capacity; ++i) {
+                const Slot& slot = shard->slots[i];
+                uint64_t before = slot.sequence.load(std::memory_order_acquire);
+                if (before == 0) {
+                    continue;
+                }
+                double value = slot.value.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                uint64_t after = slot.sequence.load(std::memory_order_relaxed);
+                if (before != after || before - 1 < oldest) {
+                    continue;
+                }
+                entries.push_back({before - 1, value});
+            }
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.sequence < b.sequence; });
+    if (entries.size() > capacity) {
+        entries.erase(entries.begin(), entries.end() - capacity);
+    }
+    return entries;
+}
+
+std::vector<double> ConcurrentCalculator::getHistory() const {
+    std::vector<Entry> entries = collectHistory();
+    std::vector<double> history;
+    history.reserve(entries.size());
+    for (const Entry& entry : entries) {
+        history.push_back(entry.value);
+    }
+    return history;
+}
+
+void ConcurrentCalculator::clearHistory() {
+    clearedBefore.store(nextSequence.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+double ConcurrentCalculator::getLastResult() const {
+    std::vector<Entry> entries = collectHistory();
+    if (entries.empty()) {
+        throw std::runtime_error("No calculations performed yet");
+    }
+    return entries.back().value;
+}
+
+uint64_t ConcurrentCalculator::getHistorySequence() const {
+    return nextSequence.load(std::memory_order_relaxed);
+}
+
+size_t ConcurrentCalculator::getHistoryCapacity() const {
+    return capacity;
+}
+
+void ConcurrentCalculator::reset() {
+    clearMemory();
+    setDegreesMode(true);
+    clearHistory();
+}
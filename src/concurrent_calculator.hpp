@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Calculator whose operations may be called from many threads at once.
+// Each thread appends to its own history shard: a single-producer ring
+// whose slots are published seqlock-style, so appends never take a lock.
+// Entries are stamped from one global sequence counter and readers merge
+// the shards by that sequence. Memory and degrees mode are atomics.
+class ConcurrentCalculator {
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        std::atomic<double> value;
+    };
+
+    struct Shard {
+        std::thread::id owner;
+        std::unique_ptr<Slot[]> slots;
+        uint64_t written;
+    };
+
+    struct Entry {
+        uint64_t sequence;
+        double value;
+    };
+
+    size_t capacity;
+    uint64_t instanceId;
+    std::atomic<uint64_t> nextSequence;
+    std::atomic<uint64_t> clearedBefore;
+    std::atomic<double> memory;
+    std::atomic<bool> degreesMode;
+
+    mutable std::mutex shardsMutex;
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    Shard& localShard();
+    std::vector<Entry> collectHistory() const;
+
+public:
+    static constexpr size_t DEFAULT_HISTORY_CAPACITY = 100;
+
+    ConcurrentCalculator();
+    explicit ConcurrentCalculator(size_t historyCapacity);
+
+    ConcurrentCalculator(const ConcurrentCalculator&) = delete;
+    ConcurrentCalculator& operator=(const ConcurrentCalculator&) = delete;
+
+    double add(double a, double b);
+    double subtract(double a, double b);
+    double multiply(double a, double b);
+    double divide(double a, double b);
+
+    double power(double base, double exponent);
+    double sqrt(double value);
+    double sin(double angle);
+    double cos(double angle);
+
+    void setMemory(double value);
+    double getMemory() const;
+    void clearMemory();
+
+    void setDegreesMode(bool degrees);
+    bool isDegreesMode() const;
+
+    void addToHistory(double value);
+    std::vector<double> getHistory() const;
+    void clearHistory();
+    double getLastResult() const;
+    uint64_t getHistorySequence() const;
+    size_t getHistoryCapacity() const;
+
+    void reset();
+};
@@ -0,0 +1,12 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Fast non-cryptographic hashing for content-addressed lookups. xxh64
+// follows the XXH64 algorithm, so values match other XXH64
+// implementations.
+namespace ContentHash {
+
+std::uint64_t xxh64(const void* data, size_t size, std::uint64_t seed = 0);
+
+}
@@ -0,0 +1,543 @@
+#include "expression.hpp"
+#include <cctype>
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+const double DEGREES_TO_RADIANS = M_PI / 180.0;
+const size_t MAX_NESTING = 256;
+
+using OpCode = CompiledExpression::OpCode;
+
+struct FunctionInfo {
+    const char* name;
+    OpCode op;
+    size_t arity;
+};
+
+const FunctionInfo FUNCTIONS[] = {
+    {"sqrt", OpCode::Sqrt, 1},
+    {"sin", OpCode::Sin, 1},
+    {"cos", OpCode::Cos, 1},
+    {"power", OpCode::Power, 2},
+};
+
+const FunctionInfo* findFunction(const std::string& name) {
+    for (const FunctionInfo& function : FUNCTIONS) {
+        if (name == function.name) {
+            return &function;
+        }
+    }
+    return nullptr;
+}
+
+double checkedDivide(double a, double b) {
+    if (b == 0.0) {
+        throw std::invalid_argument("Division by zero");
+    }
+    return a / b;
+}
+
+double checkedPower(double base, double exponent) {
+    if (base == 0.0 && exponent < 0.0) {
+        throw std::invalid_argument("Cannot raise zero to negative power");
+    }
+    return std::pow(base, exponent);
+}
+
+double checkedSqrt(double value) {
+    if (value < 0.0) {
+        throw std::invalid_argument("Cannot take square root of negative number");
+    }
+    return std::sqrt(value);
+}
+
+void fillBlock(double* __restrict dst, double value, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = value;
+    }
+}
+
+void copyBlock(double* __restrict dst, const double* __restrict src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = src[i];
+    }
+}
+
+template <typename Op>
+void unaryBlock(double* __restrict values, size_t n, Op op) {
+    for (size_t i = 0; i < n; ++i) {
+        values[i] = op(values[i]);
+    }
+}
+
+template <typename Op>
+void binaryBlock(double* __restrict lhs, const double* __restrict rhs, size_t n, Op op) {
+    for (size_t i = 0; i < n; ++i) {
+        lhs[i] = op(lhs[i], rhs[i]);
+    }
+}
+
+double applyBinary(OpCode op, double a, double b) {
+    switch (op) {
+        case OpCode::Add: return a + b;
+        case OpCode::Subtract: return a - b;
+        case OpCode::Multiply: return a * b;
+        case OpCode::Divide: return checkedDivide(a, b);
+        case OpCode::Power: return checkedPower(a, b);
+        default: throw std::logic_error("Not a binary operation");
+    }
+}
+
+}
+
+class ExpressionCompiler {
+public:
+    explicit ExpressionCompiler(const std::string& text) : source(text), pos(0), nesting(0) {
+        result.source = text;
+    }
+
+    CompiledExpression compile() {
+        skipWhitespace();
+        if (atEnd()) {
+            throw std::invalid_argument("Empty expression");
+        }
+        parseExpression();
+        skipWhitespace();
+        if (!atEnd()) {
+            if (source[pos] == ')') {
+                throw std::invalid_argument("Mismatched parentheses");
+            }
+            throw unexpectedCharacter();
+        }
+        result.stackDepth = computeStackDepth();
+        return std::move(result);
+    }
+
+private:
+    const std::string& source;
+    size_t pos;
+    size_t nesting;
+    CompiledExpression result;
+
+    bool atEnd() const {
+        return pos >= source.size();
+    }
+
+    void skipWhitespace() {
+        while (!atEnd() && std::isspace(static_cast<unsigned char>(source[pos]))) {
+            ++pos;
+        }
+    }
+
+    bool match(char c) {
+        skipWhitespace();
+        if (!atEnd() && source[pos] == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    std::invalid_argument unexpectedCharacter() const {
+        return std::invalid_argument("Unexpected character in expression: " + std::string(1, source[pos]));
+    }
+
+    void enter() {
+        if (++nesting > MAX_NESTING) {
+            throw std::invalid_argument("Expression is too deeply nested");
+        }
+    }
+
+    void parseExpression() {
+        parseTerm();
+        for (;;) {
+            if (match('+')) {
+                parseTerm();
+                emitBinary(OpCode::Add);
+            } else if (match('-')) {
+                parseTerm();
+                emitBinary(OpCode::Subtract);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void parseTerm() {
+        parseUnary();
+        for (;;) {
+            if (match('*')) {
+                parseUnary();
+                emitBinary(OpCode::Multiply);
+            } else if (match('/')) {
+                parseUnary();
+                emitBinary(OpCode::Divide);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void parseUnary() {
+        enter();
+        if (match('-')) {
+            parseUnary();
+            emitUnary(OpCode::Negate);
+        } else if (match('+')) {
+            parseUnary();
+        } else {
+            parsePower();
+        }
+        --nesting;
+    }
+
+    void parsePower() {
+        parsePrimary();
+        if (match('^')) {
+            parseUnary();
+            emitBinary(OpCode::Power);
+        }
+    }
+
+    void parsePrimary() {
+        skipWhitespace();
+        if (atEnd()) {
+            throw std::invalid_argument("Unexpected end of expression");
+        }
+
+        char c = source[pos];
+        if (c == '(') {
+            ++pos;
+            parseExpression();
+            if (!match(')')) {
+                throw std::invalid_argument("Mismatched parentheses");
+            }
+        } else if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            parseNumber();
+        } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            parseIdentifier();
+        } else {
+            throw unexpectedCharacter();
+        }
+    }
+
+    void parseNumber() {
+        size_t start = pos;
+        while (!atEnd() && std::isdigit(static_cast<unsigned char>(source[pos]))) {
+            ++pos;
+        }
+        if (!atEnd() && source[pos] == '.') {
+            ++pos;
+            while (!atEnd() && std::isdigit(static_cast<unsigned char>(source[pos]))) {
+                ++pos;
+            }
+        }
+        if (!atEnd() && (source[pos] == 'e' || source[pos] == 'E')) {
+            size_t exponent = pos + 1;
+            if (exponent < source.size() && (source[exponent] == '+' || source[exponent] == '-')) {
+                ++exponent;
+            }
+            if (exponent < source.size() && std::isdigit(static_cast<unsigned char>(source[exponent]))) {
+                pos = exponent;
+                while (!atEnd() && std::isdigit(static_cast<unsigned char>(source[pos]))) {
+                    ++pos;
+                }
+            }
+        }
+
+        std::string token = source.substr(start, pos - start);
+        if (token == ".") {
+            throw std::invalid_argument("Invalid number in expression");
+        }
+        emitConstant(std::strtod(token.c_str(), nullptr));
+    }
+
+    void parseIdentifier() {
+        size_t start = pos;
+        while (!atEnd() && (std::isalnum(static_cast<unsigned char>(source[pos])) || source[pos] == '_')) {
+            ++pos;
+        }
+        std::string name = source.substr(start, pos - start);
+
+        if (match('(')) {
+            parseCall(name);
+        } else if (name == "pi") {
+            emitConstant(M_PI);
+        } else if (name == "e") {
+            emitConstant(M_E);
+        } else if (name == "memory") {
+            emit(OpCode::PushMemory, 0, 0.0);
+        } else if (findFunction(name)) {
+            throw std::invalid_argument("Missing arguments for function: " + name);
+        } else {
+            emit(OpCode::PushVariable, variableSlot(name), 0.0);
+        }
+    }
+
+    void parseCall(const std::string& name) {
+        const FunctionInfo* function = findFunction(name);
+        if (!function) {
+            throw std::invalid_argument("Unknown function: " + name);
+        }
+
+        enter();
+        size_t arguments = 0;
+        if (!match(')')) {
+            do {
+                parseExpression();
+                ++arguments;
+            } while (match(','));
+            if (!match(')')) {
+                throw std::invalid_argument("Mismatched parentheses");
+            }
+        }
+        --nesting;
+
+        if (arguments != function->arity) {
+            throw std::invalid_argument("Wrong number of arguments for function: " + name);
+        }
+        if (function->arity == 2) {
+            emitBinary(function->op);
+        } else {
+            emitUnary(function->op);
+        }
+    }
+
+    uint32_t variableSlot(const std::string& name) {
+        for (size_t i = 0; i < result.variables.size(); ++i) {
+            if (result.variables[i] == name) {
+                return static_cast<uint32_t>(i);
+            }
+        }
+        result.variables.push_back(name);
+        return static_cast<uint32_t>(result.variables.size() - 1);
+    }
+
+    void emit(OpCode op, uint32_t slot, double value) {
+        result.code.push_back({op, slot, value});
+    }
+
+    void emitConstant(double value) {
+        emit(OpCode::PushConstant, 0, value);
+    }
+
+    bool lastIsConstant(size_t fromEnd) const {
+        return result.code.size() > fromEnd &&
+               result.code[result.code.size() - 1 - fromEnd].op == OpCode::PushConstant;
+    }
+
+    // Operations on constants are folded at compile time unless they would
+    // throw; those are left in place so evaluation reports the error.
+    void emitBinary(OpCode op) {
+        if (lastIsConstant(0) && lastIsConstant(1)) {
+            double b = result.code[result.code.size() - 1].value;
+            double a = result.code[result.code.size() - 2].value;
+            try {
+                double folded = applyBinary(op, a, b);
+                result.code.pop_back();
+                result.code.back().value = folded;
+                return;
+            } catch (const std::invalid_argument&) {
+            }
+        }
+        emit(op, 0, 0.0);
+    }
+
+    void emitUnary(OpCode op) {
+        if (lastIsConstant(0)) {
+            double& value = result.code.back().value;
+            if (op == OpCode::Negate) {
+                value = -value;
+                return;
+            }
+            if (op == OpCode::Sqrt && value >= 0.0) {
+                value = std::sqrt(value);
+                return;
+            }
+        }
+        emit(op, 0, 0.0);
+    }
+
+    size_t computeStackDepth() const {
+        size_t depth = 0;
+        size_t maxDepth = 0;
+        for (const auto& instruction : result.code) {
+            switch (instruction.op) {
+                case OpCode::PushConstant:
+                case OpCode::PushVariable:
+                case OpCode::PushMemory:
+                    ++depth;
+                    break;
+                case OpCode::Add:
+                case OpCode::Subtract:
+                case OpCode::Multiply:
+                case OpCode::Divide:
+                case OpCode::Power:
+                    --depth;
+                    break;
+                default:
+                    break;
+            }
+            if (depth > maxDepth) {
+                maxDepth = depth;
+            }
+        }
+        if (maxDepth > CompiledExpression::MAX_STACK_DEPTH) {
+            throw std::invalid_argument("Expression is too deeply nested");
+        }
+        return maxDepth;
+    }
+};
+
+CompiledExpression CompiledExpression::compile(const std::string& source) {
+    return ExpressionCompiler(source).compile();
+}
+
+double CompiledExpression::evaluate(const ExpressionContext& context) const {
+    double stack[MAX_STACK_DEPTH];
+    size_t top = 0;
+
+    for (const Instruction& instruction : code) {
+        switch (instruction.op) {
+            case OpCode::PushConstant:
+                stack[top++] = instruction.value;
+                break;
+            case OpCode::PushVariable:
+                stack[top++] = context.variables[instruction.slot];
+                break;
+            case OpCode::PushMemory:
+                stack[top++] = context.memory;
+                break;
+            case OpCode::Add:
+                --top;
+                stack[top - 1] += stack[top];
+                break;
+            case OpCode::Subtract:
+                --top;
+                stack[top - 1] -= stack[top];
+                break;
+            case OpCode::Multiply:
+                --top;
+                stack[top - 1] *= stack[top];
+                break;
+            case OpCode::Divide:
+                --top;
+                stack[top - 1] = checkedDivide(stack[top - 1], stack[top]);
+                break;
+            case OpCode::Power:
+                --top;
+                stack[top - 1] = checkedPower(stack[top - 1], stack[top]);
+                break;
+            case OpCode::Negate:
+                stack[top - 1] = -stack[top - 1];
+                break;
+            case OpCode::Sqrt:
+                stack[top - 1] = checkedSqrt(stack[top - 1]);
+                break;
+            case OpCode::Sin:
+                stack[top - 1] = std::sin(context.degreesMode ? stack[top - 1] * DEGREES_TO_RADIANS : stack[top - 1]);
+                break;
+            case OpCode::Cos:
+                stack[top - 1] = std::cos(context.degreesMode ? stack[top - 1] * DEGREES_TO_RADIANS : stack[top - 1]);
+                break;
+        }
+    }
+
+    return stack[0];
+}
+
+void CompiledExpression::evaluateBatch(const ExpressionBatchContext& context, double* out) const {
+    const size_t block = BATCH_BLOCK_SIZE;
+    std::vector<double> scratch(std::max<size_t>(stackDepth, 1) * block);
+    auto slot = [&scratch, block](size_t index) { return scratch.data() + index * block; };
+
+    for (size_t begin = 0; begin < context.rows; begin += block) {
+        const size_t n = std::min(block, context.rows - begin);
+        size_t top = 0;
+
+        for (const Instruction& instruction : code) {
+            switch (instruction.op) {
+                case OpCode::PushConstant:
+                    fillBlock(slot(top++), instruction.value, n);
+                    break;
+                case OpCode::PushVariable: {
+                    const ExpressionColumn& column = context.columns[instruction.slot];
+                    if (column.broadcast) {
+                        fillBlock(slot(top++), column.data[0], n);
+                    } else {
+                        copyBlock(slot(top++), column.data + begin, n);
+                    }
+                    break;
+                }
+                case OpCode::PushMemory:
+                    fillBlock(slot(top++), context.memory, n);
+                    break;
+                case OpCode::Add:
+                    --top;
+                    binaryBlock(slot(top - 1), slot(top), n, [](double a, double b) { return a + b; });
+                    break;
+                case OpCode::Subtract:
+                    --top;
+                    binaryBlock(slot(top - 1), slot(top), n, [](double a, double b) { return a - b; });
+                    break;
+                case OpCode::Multiply:
+                    --top;
+                    binaryBlock(slot(top - 1), slot(top), n, [](double a, double b) { return a * b; });
+                    break;
+                case OpCode::Divide:
+                    --top;
+                    binaryBlock(slot(top - 1), slot(top), n, [](double a, double b) { return a / b; });
+                    break;
+                case OpCode::Power:
+                    --top;
+                    binaryBlock(slot(top - 1), slot(top), n, [](double a, double b) { return std::pow(a, b); });
+                    break;
+                case OpCode::Negate:
+                    unaryBlock(slot(top - 1), n, [](double a) { return -a; });
+                    break;
+                case OpCode::Sqrt:
+                    unaryBlock(slot(top - 1), n, [](double a) { return std::sqrt(a); });
+                    break;
+                case OpCode::Sin:
+                    if (context.degreesMode) {
+                        unaryBlock(slot(top - 1), n, [](double a) { return a * DEGREES_TO_RADIANS; });
+                    }
+                    unaryBlock(slot(top - 1), n, [](double a) { return std::sin(a); });
+                    break;
+                case OpCode::Cos:
+                    if (context.degreesMode) {
+                        unaryBlock(slot(top - 1), n, [](double a) { return a * DEGREES_TO_RADIANS; });
+                    }
+                    unaryBlock(slot(top - 1), n, [](double a) { return std::cos(a); });
+                    break;
+            }
+        }
+
+        copyBlock(out + begin, slot(0), n);
+    }
+}
+
+const std::string& CompiledExpression::getSource() const {
+    return source;
+}
+
+const std::vector<std::string>& CompiledExpression::getVariables() const {
+    return variables;
+}
+
+const std::vector<CompiledExpression::Instruction>& CompiledExpression::getInstructions() const {
+    return code;
+}
+
+size_t CompiledExpression::getStackDepth() const {
+    return stackDepth;
+}
+
+bool CompiledExpression::isReservedName(const std::string& name) {
+    return name == "pi" || name == "e" || name == "memory" || findFunction(name) != nullptr;
+}
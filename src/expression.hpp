@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ExpressionContext {
+    const double* variables;
+    double memory;
+    bool degreesMode;
+};
+
+struct ExpressionColumn {
+    const double* data;
+    bool broadcast;
+};
+
+// Struct-of-arrays input for batch evaluation: one column per variable
+// slot, each holding `rows` values, or a single value when broadcast.
+struct ExpressionBatchContext {
+    const ExpressionColumn* columns;
+    size_t rows;
+    double memory;
+    bool degreesMode;
+};
+
+// An arithmetic expression compiled once into stack-machine bytecode.
+// Grammar: + - * / ^ with the usual precedence (^ is right associative),
+// parentheses, unary minus, numbers, the constants pi and e, `memory` for
+// the calculator memory, the functions sqrt/sin/cos/power, and any other
+// identifier as a variable. Variables are referenced by slot; the caller
+// supplies one value per entry of getVariables() at evaluation time.
+class CompiledExpression {
+public:
+    enum class OpCode : uint8_t {
+        PushConstant,
+        PushVariable,
+        PushMemory,
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Power,
+        Negate,
+        Sqrt,
+        Sin,
+        Cos
+    };
+
+    struct Instruction {
+        OpCode op;
+        uint32_t slot;
+        double value;
+    };
+
+    static constexpr size_t MAX_STACK_DEPTH = 64;
+    static constexpr size_t BATCH_BLOCK_SIZE = 256;
+
+    static CompiledExpression compile(const std::string& source);
+
+    double evaluate(const ExpressionContext& context) const;
+
+    // Runs the bytecode over blocks of rows so that each instruction is a
+    // tight loop over contiguous doubles. Unlike evaluate(), invalid
+    // operations follow IEEE semantics (inf/NaN) instead of throwing, so a
+    // single bad row cannot abort the batch.
+    void evaluateBatch(const ExpressionBatchContext& context, double* out) const;
+
+    const std::string& getSource() const;
+    const std::vector<std::string>& getVariables() const;
+    const std::vector<Instruction>& getInstructions() const;
+    size_t getStackDepth() const;
+
+    static bool isReservedName(const std::string& name);
+
+private:
+    CompiledExpression() : stackDepth(0) {}
+
+    std::string source;
+    std::vector<Instruction> code;
+    std::vector<std::string> variables;
+    size_t stackDepth;
+
+    friend class ExpressionCompiler;
+};
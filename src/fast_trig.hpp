@@ -0,0 +1,65 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// Branch-free polynomial sine/cosine for Calculator's fast trig mode.
+// Arguments are reduced to [-pi/4, pi/4] around the nearest quarter turn
+// and evaluated with truncated Taylor series (degree 11 for sine, 12 for
+// cosine). The absolute error stays below MAX_ERROR for |angle| up to
+// 1e6 degrees or 1e5 radians. Reduction in degrees is exact, so multiples
+// of 90 degrees yield exact 0 and +/-1. Being plain inline arithmetic, the
+// functions vectorise inside batch loops, where libm calls cannot.
+// Larger angles take a slow path: degrees are reduced exactly with fmod,
+// radians fall back to libm. NaN and infinite angles give NaN.
+namespace FastTrig {
+
+constexpr double MAX_ERROR = 1e-11;
+
+constexpr double DEGREES_TO_RADIANS = 3.14159265358979323846 / 180.0;
+constexpr double TWO_OVER_PI = 0.63661977236758134308;
+constexpr double PI_OVER_TWO_HIGH = 1.57079632673412561417;
+constexpr double PI_OVER_TWO_LOW = 6.07710050650619224932e-11;
+constexpr double DEGREES_LIMIT = 1e6;
+constexpr double RADIANS_LIMIT = 1e5;
+
+inline void sincosReduced(double x, int64_t quadrant, double& sine, double& cosine) {
+    const double x2 = x * x;
+    const double s = x + x * x2 * (-1.0 / 6.0 + x2 * (1.0 / 120.0 + x2 * (-1.0 / 5040.0 +
+                     x2 * (1.0 / 362880.0 + x2 * (-1.0 / 39916800.0)))));
+    const double c = 1.0 + x2 * (-0.5 + x2 * (1.0 / 24.0 + x2 * (-1.0 / 720.0 +
+                     x2 * (1.0 / 40320.0 + x2 * (-1.0 / 3628800.0 + x2 * (1.0 / 479001600.0))))));
+
+    const bool swap = (quadrant & 1) != 0;
+    const double sinBase = swap ? c : s;
+    const double cosBase = swap ? s : c;
+    sine = (quadrant & 2) ? -sinBase : sinBase;
+    cosine = ((quadrant + 1) & 2) ? -cosBase : cosBase;
+}
+
+inline void sincosDegrees(double degrees, double& sine, double& cosine) {
+    // Also taken for NaN, which fails every comparison.
+    if (!(std::fabs(degrees) <= DEGREES_LIMIT)) {
+        if (!std::isfinite(degrees)) {
+            sine = cosine = std::numeric_limits<double>::quiet_NaN();
+            return;
+        }
+        degrees = std::fmod(degrees, 360.0);
+    }
+    const double quarterTurns = std::floor(degrees * (1.0 / 90.0) + 0.5);
+    const double remainder = degrees - quarterTurns * 90.0;
+    sincosReduced(remainder * DEGREES_TO_RADIANS, static_cast<int64_t>(quarterTurns), sine, cosine);
+}
+
+inline void sincosRadians(double radians, double& sine, double& cosine) {
+    if (!(std::fabs(radians) <= RADIANS_LIMIT)) {
+        sine = std::sin(radians);
+        cosine = std::cos(radians);
+        return;
+    }
+    const double quarterTurns = std::floor(radians * TWO_OVER_PI + 0.5);
+    const double remainder = (radians - quarterTurns * PI_OVER_TWO_HIGH) - quarterTurns * PI_OVER_TWO_LOW;
+    sincosReduced(remainder, static_cast<int64_t>(quarterTurns), sine, cosine);
+}
+
+}
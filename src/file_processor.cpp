@@ -1,83 +1,407 @@
 #include "file_processor.hpp"
+#include "content_hash.hpp"
+#include "spsc_queue.hpp"
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
+
+namespace {
+
+const char PROCESSED_PREFIX[] = "PROCESSED: ";
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+bool sameFile(const FileInfo& a, const FileInfo& b) {
+    return a.exists == b.exists && a.size == b.size && a.modifiedNanos == b.modifiedNanos;
+}
+
+// A source modified within the same timestamp tick as its backup could
+// change again without its modification time moving, so that time is not
+// trusted and the next backup compares chunk hashes instead.
+FileInfo trustedSourceInfo(FileInfo source, const FileInfo& backup) {
+    if (source.modifiedNanos >= backup.modifiedNanos) {
+        source.modifiedNanos = 0;
+    }
+    return source;
+}
+
+// Calls visit(offset, data, length) for each chunk of the first `size`
+// bytes of the file, through a view when the file system offers one.
+// Stops and returns false when a read comes up short or visit fails.
+template <typename Visit>
+bool visitChunks(IFileSystem& fileSystem, const std::string& filename, size_t size, size_t chunkSize, Visit&& visit) {
+    if (std::unique_ptr<FileView> view = fileSystem.openView(filename)) {
+        if (view->size() != size) {
+            return false;
+        }
+        for (size_t offset = 0; offset < size; offset += chunkSize) {
+            if (!visit(offset, view->data() + offset, std::min(chunkSize, size - offset))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    std::unique_ptr<char[]> buffer(new char[chunkSize]);
+    for (size_t offset = 0; offset < size; offset += chunkSize) {
+        size_t length = std::min(chunkSize, size - offset);
+        if (fileSystem.readChunk(filename, offset, buffer.get(), length) != length ||
+            !visit(offset, buffer.get(), length)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct PipelineChunk {
+    size_t file = 0;
+    std::vector<char> data;
+    size_t size = 0;
+    bool first = false;
+    bool last = false;
+    bool failed = false;
+};
+
+// Parks pipeline stages that cannot make progress. A stage yields a few
+// times first; after that it sleeps on the condition variable, and the
+// other stages only take the mutex when something is parked.
+class StageParking {
+private:
+    static constexpr int SPIN_LIMIT = 64;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::atomic<int> parked{0};
+
+public:
+    template <typename Ready>
+    void waitUntil(Ready ready) {
+        for (int spin = 0; spin < SPIN_LIMIT; ++spin) {
+            if (ready()) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        parked.fetch_add(1);
+        // Pairs with the fence in notify(): either the notifier sees this
+        // stage parked, or ready() below sees the notifier's update.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        changed.wait(lock, ready);
+        parked.fetch_sub(1);
+    }
+
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            changed.notify_all();
+        }
+    }
+};
+
+// Shared by the stages of one processFilesPipelined run. The first stage
+// to throw records its exception and aborts the others.
+struct PipelineControl {
+    StageParking parking;
+    std::atomic<bool> aborted{false};
+    std::mutex failureMutex;
+    std::exception_ptr failure;
+
+    void fail(std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure) {
+                failure = error;
+            }
+        }
+        abort();
+    }
+
+    void abort() {
+        aborted.store(true);
+        parking.notify();
+    }
+};
+
+// Aborts and joins the stage threads however the calling thread leaves.
+struct StageThreads {
+    PipelineControl& control;
+    std::vector<std::thread> threads;
+
+    ~StageThreads() {
+        bool running = false;
+        for (auto& thread : threads) {
+            running = running || thread.joinable();
+        }
+        if (running) {
+            control.abort();
+        }
+        for (auto& thread : threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+};
+
+// Waits until the queue has room, charging the wait to the stage. False
+// when the pipeline was aborted first.
+template <typename T>
+bool pushWithBackpressure(SpscQueue<T>& queue, T& item, PipelineStageStats& stats, PipelineControl& control) {
+    if (queue.tryPush(item)) {
+        control.parking.notify();
+        return true;
+    }
+    Clock::time_point start = Clock::now();
+    bool pushed = false;
+    control.parking.waitUntil([&]() {
+        pushed = queue.tryPush(item);
+        return pushed || control.aborted.load();
+    });
+    stats.stalledSeconds += secondsSince(start);
+    if (pushed) {
+        control.parking.notify();
+    }
+    return pushed;
+}
+
+// Waits for the next item; false once the producer has closed the queue
+// and everything has been consumed, or the pipeline was aborted.
+template <typename T>
+bool popOrWait(SpscQueue<T>& queue, T& item, PipelineStageStats& stats, PipelineControl& control) {
+    if (queue.tryPop(item)) {
+        control.parking.notify();
+        return true;
+    }
+    Clock::time_point start = Clock::now();
+    bool popped = false;
+    control.parking.waitUntil([&]() {
+        popped = queue.tryPop(item);
+        return popped || queue.isDrained() || control.aborted.load();
+    });
+    stats.stalledSeconds += secondsSince(start);
+    if (popped) {
+        control.parking.notify();
+    }
+    return popped;
+}
+
+}
 
 FileProcessor::FileProcessor(std::unique_ptr<IFileSystem> fs, 
                            std::unique_ptr<INetworkClient> net, 
                            std::unique_ptr<ILogger> log)
-    : fileSystem(std::move(fs)), networkClient(std::move(net)), logger(std::move(log)), totalProcessedSize(0) {}
+    : fileSystem(std::move(fs)), networkClient(std::move(net)), logger(std::move(log)), totalProcessedSize(0),
+      transform(ByteTransform::toUpperAscii), workerCount(1) {}
 
 bool FileProcessor::processFile(const std::string& inputFile, const std::string& outputFile) {
     if (inputFile.empty() || outputFile.empty()) {
-        logger->error("Invalid file names provided");
+        logger->log(LogLevel::Error, "Invalid file names provided");
         return false;
     }
     
     if (!fileSystem->fileExists(inputFile)) {
-        logger->error("Input file does not exist: " + inputFile);
+        logger->log(LogLevel::Error, "Input file does not exist: ", inputFile);
         return false;
     }
     
-    logger->info("Processing file: " + inputFile);
+    if (std::unique_ptr<FileView> view = fileSystem->openView(inputFile)) {
+        return processView(*view, inputFile, outputFile);
+    }
+    
+    if (fileSystem->supportsChunkedIo() && fileSystem->getFileSize(inputFile) > MAX_IN_MEMORY_SIZE) {
+        return processFileStreaming(inputFile, outputFile);
+    }
+    
+    logger->log(LogLevel::Info, "Processing file: ", inputFile);
     
     std::string content = fileSystem->readFile(inputFile);
     if (content.empty()) {
-        logger->warning("Input file is empty: " + inputFile);
+        logger->log(LogLevel::Warning, "Input file is empty: ", inputFile);
         return false;
     }
     
     if (!validateContent(content)) {
-        logger->error("Content validation failed for: " + inputFile);
+        logger->log(LogLevel::Error, "Content validation failed for: ", inputFile);
         return false;
     }
     
-    std::string transformedContent = transformContent(content);
-    bool success = fileSystem->writeFile(outputFile, transformedContent);
+    std::shared_ptr<const std::string> transformedContent = transformCached(content.data(), content.size());
+    bool success = fileSystem->writeFile(outputFile, *transformedContent);
     
     if (success) {
         totalProcessedSize += content.size();
-        logger->info("File processed successfully: " + inputFile + " -> " + outputFile);
+        logger->log(LogLevel::Info, "File processed successfully: ", inputFile, " -> ", outputFile);
+    } else {
+        logger->log(LogLevel::Error, "Failed to write output file: ", outputFile);
+    }
+    
+    return success;
+}
+
+// Reads, transforms and appends one chunk at a time, so memory use is
+// bounded by chunkSize whatever the size of the input.
+bool FileProcessor::processFileStreaming(const std::string& inputFile, const std::string& outputFile,
+                                         size_t chunkSize) {
+    if (inputFile.empty() || outputFile.empty()) {
+        logger->log(LogLevel::Error, "Invalid file names provided");
+        return false;
+    }
+    
+    if (chunkSize == 0) {
+        logger->log(LogLevel::Error, "Chunk size must be positive");
+        return false;
+    }
+    
+    if (!fileSystem->fileExists(inputFile)) {
+        logger->log(LogLevel::Error, "Input file does not exist: ", inputFile);
+        return false;
+    }
+    
+    size_t fileSize = fileSystem->getFileSize(inputFile);
+    if (fileSize == 0) {
+        logger->log(LogLevel::Warning, "Input file is empty: ", inputFile);
+        return false;
+    }
+    
+    logger->log(LogLevel::Info, "Streaming file: ", inputFile);
+    
+    std::string stagingFile = stagingFileFor(inputFile, outputFile);
+    if (!fileSystem->writeFile(stagingFile, PROCESSED_PREFIX)) {
+        logger->log(LogLevel::Error, "Failed to write output file: ", outputFile);
+        commitStagedOutput(stagingFile, outputFile, false);
+        return false;
+    }
+    
+    std::unique_ptr<char[]> buffer(new char[chunkSize]);
+    size_t offset = 0;
+    while (offset < fileSize) {
+        size_t count = fileSystem->readChunk(inputFile, offset, buffer.get(), std::min(chunkSize, fileSize - offset));
+        if (count == 0) {
+            logger->log(LogLevel::Error, "Failed to read input file: ", inputFile);
+            commitStagedOutput(stagingFile, outputFile, false);
+            return false;
+        }
+        
+        transformBytes(buffer.get(), buffer.get(), count);
+        if (!fileSystem->appendChunk(stagingFile, buffer.get(), count)) {
+            logger->log(LogLevel::Error, "Failed to write output file: ", outputFile);
+            commitStagedOutput(stagingFile, outputFile, false);
+            return false;
+        }
+        offset += count;
+    }
+    
+    if (!commitStagedOutput(stagingFile, outputFile, true)) {
+        logger->log(LogLevel::Error, "Failed to write output file: ", outputFile);
+        return false;
+    }
+    
+    totalProcessedSize += offset;
+    logger->log(LogLevel::Info, "File processed successfully: ", inputFile, " -> ", outputFile);
+    return true;
+}
+
+// Transforms straight out of the mapped input. Small files produce their
+// output in one write; larger ones are written in chunks so the output
+// buffer stays bounded.
+bool FileProcessor::processView(const FileView& view, const std::string& inputFile, const std::string& outputFile) {
+    logger->log(LogLevel::Info, "Processing mapped file: ", inputFile);
+    
+    const char* input = view.data();
+    size_t size = view.size();
+    if (size == 0) {
+        logger->log(LogLevel::Warning, "Input file is empty: ", inputFile);
+        return false;
+    }
+    
+    bool success;
+    if (size <= MAX_IN_MEMORY_SIZE) {
+        success = fileSystem->writeFile(outputFile, *transformCached(input, size));
+    } else {
+        std::string stagingFile = stagingFileFor(inputFile, outputFile);
+        success = fileSystem->writeFile(stagingFile, PROCESSED_PREFIX);
+        std::unique_ptr<char[]> buffer(new char[DEFAULT_CHUNK_SIZE]);
+        for (size_t offset = 0; success && offset < size; offset += DEFAULT_CHUNK_SIZE) {
+            size_t count = std::min(DEFAULT_CHUNK_SIZE, size - offset);
+            transformBytes(input + offset, buffer.get(), count);
+            success = fileSystem->appendChunk(stagingFile, buffer.get(), count);
+        }
+        success = commitStagedOutput(stagingFile, outputFile, success);
+    }
+    
+    if (success) {
+        totalProcessedSize += size;
+        logger->log(LogLevel::Info, "File processed successfully: ", inputFile, " -> ", outputFile);
     } else {
-        logger->error("Failed to write output file: " + outputFile);
+        logger->log(LogLevel::Error, "Failed to write output file: ", outputFile);
     }
     
     return success;
 }
 
+// Output written a chunk at a time must not truncate an input that is
+// still being read, so processing a file onto itself goes through a
+// temporary file that replaces the original once it is complete.
+std::string FileProcessor::stagingFileFor(const std::string& inputFile, const std::string& outputFile) {
+    return fileSystem->isSameFile(inputFile, outputFile) ? outputFile + ".tmp" : outputFile;
+}
+
+bool FileProcessor::commitStagedOutput(const std::string& stagingFile, const std::string& outputFile, bool success) {
+    if (stagingFile == outputFile) {
+        return success;
+    }
+    if (success && fileSystem->renameFile(stagingFile, outputFile)) {
+        return true;
+    }
+    fileSystem->deleteFile(stagingFile);
+    return false;
+}
+
 bool FileProcessor::downloadAndProcess(const std::string& url, const std::string& outputFile) {
     if (url.empty() || outputFile.empty()) {
-        logger->error("Invalid URL or output file name");
+        logger->log(LogLevel::Error, "Invalid URL or output file name");
         return false;
     }
     
-    logger->info("Downloading from URL: " + url);
+    logger->log(LogLevel::Info, "Downloading from URL: ", url);
     
     networkClient->setTimeout(30);
     std::string content = networkClient->get(url);
     
     if (networkClient->getResponseCode() != 200) {
-        logger->error("Failed to download from URL: " + url);
+        logger->log(LogLevel::Error, "Failed to download from URL: ", url);
         return false;
     }
     
     if (content.empty()) {
-        logger->warning("Downloaded content is empty from: " + url);
+        logger->log(LogLevel::Warning, "Downloaded content is empty from: ", url);
         return false;
     }
     
     if (!validateContent(content)) {
-        logger->error("Downloaded content validation failed from: " + url);
+        logger->log(LogLevel::Error, "Downloaded content validation failed from: ", url);
         return false;
     }
     
-    std::string transformedContent = transformContent(content);
-    bool success = fileSystem->writeFile(outputFile, transformedContent);
+    std::shared_ptr<const std::string> transformedContent = transformCached(content.data(), content.size());
+    bool success = fileSystem->writeFile(outputFile, *transformedContent);
     
     if (success) {
         totalProcessedSize += content.size();
-        logger->info("URL content processed successfully: " + url + " -> " + outputFile);
+        logger->log(LogLevel::Info, "URL content processed successfully: ", url, " -> ", outputFile);
     } else {
-        logger->error("Failed to save processed content to: " + outputFile);
+        logger->log(LogLevel::Error, "Failed to save processed content to: ", outputFile);
     }
     
     return success;
@@ -85,54 +409,461 @@ bool FileProcessor::downloadAndProcess(const std::string& url, const std::string
 
 bool FileProcessor::backupFile(const std::string& filename) {
     if (filename.empty()) {
-        logger->error("Cannot backup: empty filename");
+        logger->log(LogLevel::Error, "Cannot backup: empty filename");
         return false;
     }
     
-    if (!fileSystem->fileExists(filename)) {
-        logger->error("Cannot backup non-existent file: " + filename);
+    FileInfo source = fileSystem->getFileInfo(filename);
+    if (!source.exists) {
+        logger->log(LogLevel::Error, "Cannot backup non-existent file: ", filename);
         return false;
     }
     
     std::string backupName = filename + ".backup";
-    std::string content = fileSystem->readFile(filename);
+    auto known = backupManifests.find(filename);
+    bool backupIntact = known != backupManifests.end() &&
+                        sameFile(fileSystem->getFileInfo(backupName), known->second.backup);
+    
+    if (backupIntact && source.modifiedNanos != 0 && sameFile(source, known->second.source)) {
+        ++backupStats.skipped;
+        logger->log(LogLevel::Info, "Backup is up to date: ", backupName);
+        return true;
+    }
+    
+    std::vector<std::uint64_t> hashes;
+    if (backupIntact && source.size == known->second.source.size) {
+        const std::vector<std::uint64_t>& previous = known->second.chunkHashes;
+        size_t rewritten = 0;
+        bool patched = visitChunks(*fileSystem, filename, source.size, BACKUP_CHUNK_SIZE,
+                                   [&](size_t offset, const char* data, size_t length) {
+            hashes.push_back(ContentHash::xxh64(data, length));
+            if (hashes.back() == previous[hashes.size() - 1]) {
+                return true;
+            }
+            ++rewritten;
+            return fileSystem->writeChunkAt(backupName, offset, data, length);
+        });
+        
+        if (patched) {
+            if (rewritten == 0) {
+                ++backupStats.skipped;
+            } else {
+                ++backupStats.incrementalUpdates;
+                backupStats.chunksRewritten += rewritten;
+            }
+            FileInfo backup = fileSystem->getFileInfo(backupName);
+            known->second = BackupManifest{trustedSourceInfo(source, backup), backup, std::move(hashes)};
+            logger->log(LogLevel::Info, "File backed up incrementally: ", filename, " -> ", backupName);
+            return true;
+        }
+        hashes.clear();
+    }
     
-    bool success = fileSystem->writeFile(backupName, content);
+    bool success = fileSystem->copyFile(filename, backupName);
     
     if (success) {
-        logger->info("File backed up successfully: " + filename + " -> " + backupName);
+        ++backupStats.fullCopies;
+        logger->log(LogLevel::Info, "File backed up successfully: ", filename, " -> ", backupName);
+        
+        // The manifest is only trusted if the source did not change while
+        // it was being copied and hashed.
+        bool hashed = visitChunks(*fileSystem, filename, source.size, BACKUP_CHUNK_SIZE,
+                                  [&hashes](size_t, const char* data, size_t length) {
+            hashes.push_back(ContentHash::xxh64(data, length));
+            return true;
+        });
+        if (hashed && sameFile(fileSystem->getFileInfo(filename), source)) {
+            FileInfo backup = fileSystem->getFileInfo(backupName);
+            backupManifests[filename] = BackupManifest{trustedSourceInfo(source, backup), backup, std::move(hashes)};
+        } else {
+            backupManifests.erase(filename);
+        }
     } else {
-        logger->error("Failed to backup file: " + filename);
+        backupManifests.erase(filename);
+        logger->log(LogLevel::Error, "Failed to backup file: ", filename);
     }
     
     return success;
 }
 
+BackupStats FileProcessor::getBackupStats() const {
+    return backupStats;
+}
+
 std::vector<std::string> FileProcessor::processMultipleFiles(const std::vector<std::string>& files) {
     std::vector<std::string> results;
     
-    logger->info("Processing multiple files, count: " + std::to_string(files.size()));
+    logger->log(LogLevel::Info, "Processing multiple files, count: ", files.size());
     
-    for (const auto& file : files) {
-        std::string outputFile = file + ".processed";
-        if (processFile(file, outputFile)) {
-            results.push_back(outputFile);
+    if (workerCount > 1 && files.size() > 1) {
+        results = processFilesInParallel(files);
+    } else {
+        for (const auto& file : files) {
+            std::string outputFile = file + ".processed";
+            if (processFile(file, outputFile)) {
+                results.push_back(outputFile);
+            }
         }
     }
     
-    logger->info("Successfully processed " + std::to_string(results.size()) + " out of " + std::to_string(files.size()) + " files");
+    logger->log(LogLevel::Info, "Successfully processed ", results.size(), " out of ", files.size(), " files");
     
     return results;
 }
 
+// Workers claim small batches of indices from a shared cursor, so a slow
+// file only holds up its own batch, and record success per index. The
+// output list is assembled afterwards in input order.
+std::vector<std::string> FileProcessor::processFilesInParallel(const std::vector<std::string>& files) {
+    if (!workers || workers->size() != workerCount) {
+        workers = std::make_unique<ThreadPool>(workerCount);
+    }
+    
+    const size_t batch = std::max<size_t>(1, std::min<size_t>(64, files.size() / (workerCount * 8)));
+    std::atomic<size_t> cursor(0);
+    std::vector<unsigned char> succeeded(files.size(), 0);
+    
+    std::vector<std::future<void>> running;
+    for (size_t w = 0; w < std::min(workerCount, files.size()); ++w) {
+        running.push_back(workers->submit([this, &files, &cursor, &succeeded, batch]() {
+            for (;;) {
+                size_t begin = cursor.fetch_add(batch, std::memory_order_relaxed);
+                if (begin >= files.size()) {
+                    return;
+                }
+                size_t end = std::min(files.size(), begin + batch);
+                for (size_t i = begin; i < end; ++i) {
+                    succeeded[i] = processFile(files[i], files[i] + ".processed");
+                }
+            }
+        }));
+    }
+    for (auto& worker : running) {
+        worker.wait();
+    }
+    for (auto& worker : running) {
+        worker.get();
+    }
+    
+    std::vector<std::string> results;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (succeeded[i]) {
+            results.push_back(files[i] + ".processed");
+        }
+    }
+    return results;
+}
+
+// Chunk buffers travel reader -> transformer -> writer and are handed back
+// to the reader through a recycle queue, so the steady state allocates
+// nothing. Each thread owns its stage's statistics; they are combined after
+// the joins.
+std::vector<std::string> FileProcessor::processFilesPipelined(const std::vector<std::string>& files,
+                                                              size_t chunkSize, size_t queueDepth) {
+    logger->log(LogLevel::Info, "Pipelining multiple files, count: ", files.size());
+    
+    chunkSize = std::max<size_t>(1, chunkSize);
+    queueDepth = std::max<size_t>(1, queueDepth);
+    SpscQueue<PipelineChunk> readQueue(queueDepth);
+    SpscQueue<PipelineChunk> writeQueue(queueDepth);
+    SpscQueue<std::vector<char>> recycled(readQueue.capacity() + writeQueue.capacity() + 2);
+    std::vector<unsigned char> succeeded(files.size(), 0);
+    PipelineStats stats;
+    PipelineControl control;
+    Clock::time_point started = Clock::now();
+    
+    auto readStage = [&]() {
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (!fileSystem->fileExists(files[i])) {
+                logger->log(LogLevel::Error, "Input file does not exist: ", files[i]);
+                continue;
+            }
+            size_t fileSize = fileSystem->getFileSize(files[i]);
+            if (fileSize == 0) {
+                logger->log(LogLevel::Warning, "Input file is empty: ", files[i]);
+                continue;
+            }
+            
+            for (size_t offset = 0; offset < fileSize;) {
+                PipelineChunk chunk;
+                chunk.file = i;
+                if (!recycled.tryPop(chunk.data)) {
+                    chunk.data.resize(chunkSize);
+                }
+                
+                Clock::time_point start = Clock::now();
+                chunk.size = fileSystem->readChunk(files[i], offset, chunk.data.data(),
+                                                   std::min(chunkSize, fileSize - offset));
+                stats.read.busySeconds += secondsSince(start);
+                
+                chunk.first = offset == 0;
+                chunk.failed = chunk.size == 0;
+                offset += chunk.size;
+                chunk.last = chunk.failed || offset >= fileSize;
+                bool last = chunk.last;
+                
+                ++stats.read.chunks;
+                stats.read.bytes += chunk.size;
+                if (!pushWithBackpressure(readQueue, chunk, stats.read, control)) {
+                    return;
+                }
+                if (last) {
+                    break;
+                }
+            }
+        }
+    };
+    
+    auto transformStage = [&]() {
+        PipelineChunk chunk;
+        while (popOrWait(readQueue, chunk, stats.transform, control)) {
+            Clock::time_point start = Clock::now();
+            transformBytes(chunk.data.data(), chunk.data.data(), chunk.size);
+            stats.transform.busySeconds += secondsSince(start);
+            ++stats.transform.chunks;
+            stats.transform.bytes += chunk.size;
+            if (!pushWithBackpressure(writeQueue, chunk, stats.transform, control)) {
+                return;
+            }
+        }
+    };
+    
+    // Each stage closes its output queue however it ends, so the next
+    // stage always finishes.
+    auto runStage = [&control](SpscQueue<PipelineChunk>& output, auto stage) {
+        return [&control, &output, stage]() {
+            try {
+                stage();
+            } catch (...) {
+                control.fail(std::current_exception());
+            }
+            output.close();
+            control.parking.notify();
+        };
+    };
+    
+    // The output file is only created once its first chunk has been read,
+    // and is removed again if a later read or write fails.
+    std::vector<unsigned char> writable(files.size(), 0);
+    std::vector<unsigned char> created(files.size(), 0);
+    std::vector<size_t> written(files.size(), 0);
+    auto writeStage = [&]() {
+        PipelineChunk chunk;
+        while (popOrWait(writeQueue, chunk, stats.write, control)) {
+            const size_t i = chunk.file;
+            const std::string outputFile = files[i] + ".processed";
+            
+            Clock::time_point start = Clock::now();
+            if (chunk.first) {
+                writable[i] = 1;
+            }
+            if (!chunk.failed && writable[i] && !created[i]) {
+                writable[i] = fileSystem->writeFile(outputFile, PROCESSED_PREFIX);
+                created[i] = 1;
+            }
+            if (!chunk.failed && writable[i]) {
+                writable[i] = fileSystem->appendChunk(outputFile, chunk.data.data(), chunk.size);
+                written[i] += chunk.size;
+            }
+            if (created[i] && (chunk.failed || (chunk.last && !writable[i]))) {
+                fileSystem->deleteFile(outputFile);
+            }
+            stats.write.busySeconds += secondsSince(start);
+            ++stats.write.chunks;
+            stats.write.bytes += chunk.size;
+            
+            if (chunk.failed) {
+                logger->log(LogLevel::Error, "Failed to read input file: ", files[i]);
+            } else if (chunk.last && writable[i]) {
+                succeeded[i] = 1;
+                totalProcessedSize += written[i];
+                logger->log(LogLevel::Info, "File processed successfully: ", files[i], " -> ", outputFile);
+            } else if (chunk.last) {
+                logger->log(LogLevel::Error, "Failed to write output file: ", outputFile);
+            }
+            if (chunk.last) {
+                created[i] = 0;
+            }
+            recycled.tryPush(chunk.data);
+        }
+    };
+    
+    {
+        StageThreads stages{control, {}};
+        stages.threads.emplace_back(runStage(readQueue, readStage));
+        stages.threads.emplace_back(runStage(writeQueue, transformStage));
+        try {
+            writeStage();
+        } catch (...) {
+            control.fail(std::current_exception());
+        }
+        for (auto& thread : stages.threads) {
+            thread.join();
+        }
+    }
+    if (control.failure) {
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (created[i]) {
+                fileSystem->deleteFile(files[i] + ".processed");
+            }
+        }
+        std::rethrow_exception(control.failure);
+    }
+    stats.elapsedSeconds = secondsSince(started);
+    pipelineStats = stats;
+    
+    std::vector<std::string> results;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (succeeded[i]) {
+            results.push_back(files[i] + ".processed");
+        }
+    }
+    
+    logger->log(LogLevel::Info, "Successfully processed ", results.size(), " out of ", files.size(), " files");
+    
+    return results;
+}
+
+void FileProcessor::setAsyncFileSystem(std::unique_ptr<IAsyncFileSystem> fs) {
+    asyncFileSystem = std::move(fs);
+}
+
+// Files are handled in windows of maxInFlight: all reads of a window are
+// issued up front, each result is transformed as it arrives in order and
+// its write issued immediately, and the window's writes are collected
+// before the next window starts.
+std::vector<std::string> FileProcessor::processMultipleFilesAsync(const std::vector<std::string>& files,
+                                                                  size_t maxInFlight) {
+    if (!asyncFileSystem) {
+        return processMultipleFiles(files);
+    }
+    
+    std::vector<std::string> results;
+    
+    logger->log(LogLevel::Info, "Processing multiple files asynchronously, count: ", files.size());
+    
+    maxInFlight = std::max<size_t>(1, maxInFlight);
+    for (size_t begin = 0; begin < files.size(); begin += maxInFlight) {
+        size_t end = std::min(files.size(), begin + maxInFlight);
+        
+        std::vector<std::future<std::string>> reads;
+        reads.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            reads.push_back(asyncFileSystem->readFileAsync(files[i]));
+        }
+        
+        std::vector<std::future<bool>> writes(end - begin);
+        std::vector<size_t> sizes(end - begin, 0);
+        for (size_t i = begin; i < end; ++i) {
+            std::string content;
+            try {
+                content = reads[i - begin].get();
+            } catch (const std::runtime_error& error) {
+                logger->log(LogLevel::Error, error.what());
+                continue;
+            }
+            
+            if (content.empty()) {
+                logger->log(LogLevel::Warning, "Input file is empty: ", files[i]);
+                continue;
+            }
+            
+            if (!validateContent(content)) {
+                logger->log(LogLevel::Error, "Content validation failed for: ", files[i]);
+                continue;
+            }
+            
+            sizes[i - begin] = content.size();
+            writes[i - begin] = asyncFileSystem->writeFileAsync(files[i] + ".processed",
+                                                              *transformCached(content.data(), content.size()));
+        }
+        
+        for (size_t i = begin; i < end; ++i) {
+            std::future<bool>& write = writes[i - begin];
+            if (!write.valid()) {
+                continue;
+            }
+            std::string outputFile = files[i] + ".processed";
+            if (write.get()) {
+                totalProcessedSize += sizes[i - begin];
+                results.push_back(outputFile);
+                logger->log(LogLevel::Info, "File processed successfully: ", files[i], " -> ", outputFile);
+            } else {
+                logger->log(LogLevel::Error, "Failed to write output file: ", outputFile);
+            }
+        }
+    }
+    
+    logger->log(LogLevel::Info, "Successfully processed ", results.size(), " out of ", files.size(), " files");
+    
+    return results;
+}
+
+PipelineStats FileProcessor::getPipelineStats() const {
+    return pipelineStats;
+}
+
 size_t FileProcessor::getTotalProcessedSize() const {
-    return totalProcessedSize;
+    return totalProcessedSize.load();
+}
+
+void FileProcessor::setWorkerCount(size_t count) {
+    workerCount = std::max<size_t>(1, count);
+}
+
+size_t FileProcessor::getWorkerCount() const {
+    return workerCount;
+}
+
+std::string FileProcessor::transformContent(const char* data, size_t size) {
+    const size_t prefixLength = sizeof(PROCESSED_PREFIX) - 1;
+    std::string transformed(prefixLength + size, '\0');
+    transformed.replace(0, prefixLength, PROCESSED_PREFIX);
+    transformBytes(data, &transformed[prefixLength], size);
+    return transformed;
+}
+
+// With the cache enabled a repeated input costs one hash, a lookup and a
+// comparison against the stored input.
+std::shared_ptr<const std::string> FileProcessor::transformCached(const char* data, size_t size) {
+    if (!transformCache) {
+        return std::make_shared<const std::string>(transformContent(data, size));
+    }
+    
+    std::uint64_t hash = ContentHash::xxh64(data, size);
+    if (std::shared_ptr<const std::string> cached = transformCache->find(hash, data, size)) {
+        return cached;
+    }
+    auto transformed = std::make_shared<const std::string>(transformContent(data, size));
+    transformCache->insert(hash, data, size, transformed);
+    return transformed;
+}
+
+void FileProcessor::enableTransformCache(size_t capacityBytes) {
+    if (capacityBytes == 0) {
+        transformCache.reset();
+    } else {
+        transformCache = std::make_unique<TransformCache>(capacityBytes);
+    }
+}
+
+TransformCacheStats FileProcessor::getTransformCacheStats() const {
+    return transformCache ? transformCache->stats() : TransformCacheStats();
+}
+
+void FileProcessor::transformBytes(const char* input, char* output, size_t size) {
+    transform(input, output, size);
+}
+
+void FileProcessor::setTransform(ByteTransform::Kernel kernel) {
+    transform = kernel ? kernel : ByteTransform::copy;
+    if (transformCache) {
+        transformCache->clear();
+    }
 }
 
-std::string FileProcessor::transformContent(const std::string& content) {
-    std::string transformed = content;
-    std::transform(transformed.begin(), transformed.end(), transformed.begin(), ::toupper);
-    return "PROCESSED: " + transformed;
+ByteTransform::Kernel FileProcessor::getTransform() const {
+    return transform;
 }
 
 bool FileProcessor::validateContent(const std::string& content) {
@@ -1,29 +1,130 @@
 #pragma once
+#include "byte_transform.hpp"
 #include "interfaces.hpp"
+#include "thread_pool.hpp"
+#include "transform_cache.hpp"
+#include <atomic>
 #include <string>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
+// Counters for one stage of processFilesPipelined. Busy time excludes
+// time spent waiting on a full output queue or an empty input queue.
+struct PipelineStageStats {
+    size_t chunks = 0;
+    size_t bytes = 0;
+    double busySeconds = 0.0;
+    double stalledSeconds = 0.0;
+
+    // Bytes per busy second.
+    double throughput() const { return busySeconds > 0.0 ? bytes / busySeconds : 0.0; }
+};
+
+struct PipelineStats {
+    PipelineStageStats read;
+    PipelineStageStats transform;
+    PipelineStageStats write;
+    double elapsedSeconds = 0.0;
+};
+
+// What backupFile did across calls. Skipped backups were already current;
+// incremental updates rewrote only the chunks whose hashes changed.
+struct BackupStats {
+    size_t skipped = 0;
+    size_t fullCopies = 0;
+    size_t incrementalUpdates = 0;
+    size_t chunksRewritten = 0;
+};
+
 class FileProcessor {
 private:
     std::unique_ptr<IFileSystem> fileSystem;
     std::unique_ptr<INetworkClient> networkClient;
     std::unique_ptr<ILogger> logger;
+    std::unique_ptr<IAsyncFileSystem> asyncFileSystem;
     
 public:
     FileProcessor(std::unique_ptr<IFileSystem> fs, 
                   std::unique_ptr<INetworkClient> net, 
                   std::unique_ptr<ILogger> log);
     
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+    // Inputs larger than this are streamed rather than read whole, when the
+    // file system supports chunked I/O.
+    static constexpr size_t MAX_IN_MEMORY_SIZE = 1000000;
+
     bool processFile(const std::string& inputFile, const std::string& outputFile);
+    bool processFileStreaming(const std::string& inputFile, const std::string& outputFile,
+                              size_t chunkSize = DEFAULT_CHUNK_SIZE);
     bool downloadAndProcess(const std::string& url, const std::string& outputFile);
+    // Keeps <filename>.backup current. A backup this processor wrote is
+    // skipped while the size and modification time of both files are
+    // unchanged, and is patched chunk by chunk when the source changed but
+    // kept its size. Anything else is a full copy through the file system.
+    static constexpr size_t BACKUP_CHUNK_SIZE = 64 * 1024;
     bool backupFile(const std::string& filename);
+    BackupStats getBackupStats() const;
     std::vector<std::string> processMultipleFiles(const std::vector<std::string>& files);
+    
+    // Reads, transforms and writes on three threads joined by bounded
+    // queues of queueDepth chunks, so I/O overlaps the transform. The file
+    // system and logger are used from all three threads. An exception from
+    // any stage stops the others and is rethrown on the calling thread.
+    static constexpr size_t DEFAULT_PIPELINE_DEPTH = 8;
+    std::vector<std::string> processFilesPipelined(const std::vector<std::string>& files,
+                                                   size_t chunkSize = DEFAULT_CHUNK_SIZE,
+                                                   size_t queueDepth = DEFAULT_PIPELINE_DEPTH);
+    PipelineStats getPipelineStats() const;
+    
+    // Keeps up to maxInFlight reads and writes outstanding on the async
+    // file system from the calling thread. Without one, this is
+    // processMultipleFiles.
+    static constexpr size_t DEFAULT_MAX_IN_FLIGHT = 256;
+    void setAsyncFileSystem(std::unique_ptr<IAsyncFileSystem> fs);
+    std::vector<std::string> processMultipleFilesAsync(const std::vector<std::string>& files,
+                                                       size_t maxInFlight = DEFAULT_MAX_IN_FLIGHT);
     size_t getTotalProcessedSize() const;
     
+    // With more than one worker, processMultipleFiles runs files
+    // concurrently; the file system and logger must then be thread-safe.
+    void setWorkerCount(size_t count);
+    size_t getWorkerCount() const;
+    
+    // Byte transform applied to file contents; ASCII upper-casing by default.
+    // Changing it empties the transform cache.
+    void setTransform(ByteTransform::Kernel kernel);
+    ByteTransform::Kernel getTransform() const;
+    
+    // Caches whole-file outputs by input content, up to capacityBytes of
+    // inputs and outputs together. Off by default; zero disables it again.
+    // Streamed files are never cached.
+    void enableTransformCache(size_t capacityBytes);
+    TransformCacheStats getTransformCacheStats() const;
+    
 private:
-    std::string transformContent(const std::string& content);
+    struct BackupManifest {
+        FileInfo source;
+        FileInfo backup;
+        std::vector<std::uint64_t> chunkHashes;
+    };
+    
+    std::string transformContent(const char* data, size_t size);
+    std::shared_ptr<const std::string> transformCached(const char* data, size_t size);
+    bool processView(const FileView& view, const std::string& inputFile, const std::string& outputFile);
+    std::string stagingFileFor(const std::string& inputFile, const std::string& outputFile);
+    bool commitStagedOutput(const std::string& stagingFile, const std::string& outputFile, bool success);
+    void transformBytes(const char* input, char* output, size_t size);
     bool validateContent(const std::string& content);
     
-    size_t totalProcessedSize;
+    std::vector<std::string> processFilesInParallel(const std::vector<std::string>& files);
+    
+    std::atomic<size_t> totalProcessedSize;
+    ByteTransform::Kernel transform;
+    size_t workerCount;
+    std::unique_ptr<ThreadPool> workers;
+    PipelineStats pipelineStats;
+    std::unique_ptr<TransformCache> transformCache;
+    std::unordered_map<std::string, BackupManifest> backupManifests;
+    BackupStats backupStats;
 };
\ No newline at end of file
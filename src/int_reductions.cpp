@@ -0,0 +1,242 @@
+#include "int_reductions.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <climits>
+#include <future>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define INT_REDUCTIONS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using IntReductions::Isa;
+using IntReductions::Summary;
+
+Summary emptySummary() {
+    return {INT_MAX, INT_MIN, 0, 0.0};
+}
+
+template <bool Squares>
+void reduceTail(Summary& summary, const int* values, size_t count, int shift) {
+    for (size_t i = 0; i < count; ++i) {
+        summary.min = std::min(summary.min, values[i]);
+        summary.max = std::max(summary.max, values[i]);
+        summary.sum += values[i];
+        if (Squares) {
+            double d = static_cast<double>(values[i]) - shift;
+            summary.shiftedSquares += d * d;
+        }
+    }
+}
+
+template <bool Squares>
+Summary reduceScalar(const int* values, size_t count, int shift) {
+    Summary summary = emptySummary();
+    reduceTail<Squares>(summary, values, count, shift);
+    return summary;
+}
+
+#ifdef INT_REDUCTIONS_X86
+
+template <bool Squares>
+__attribute__((target("sse4.1"))) Summary reduceSse41(const int* values, size_t count, int shift) {
+    __m128i minimum = _mm_set1_epi32(INT_MAX);
+    __m128i maximum = _mm_set1_epi32(INT_MIN);
+    __m128i sumLow = _mm_setzero_si128();
+    __m128i sumHigh = _mm_setzero_si128();
+    __m128d squaresLow = _mm_setzero_pd();
+    __m128d squaresHigh = _mm_setzero_pd();
+    const __m128d offset = _mm_set1_pd(shift);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        __m128i upper = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+        minimum = _mm_min_epi32(minimum, v);
+        maximum = _mm_max_epi32(maximum, v);
+        sumLow = _mm_add_epi64(sumLow, _mm_cvtepi32_epi64(v));
+        sumHigh = _mm_add_epi64(sumHigh, _mm_cvtepi32_epi64(upper));
+        if (Squares) {
+            __m128d low = _mm_sub_pd(_mm_cvtepi32_pd(v), offset);
+            __m128d high = _mm_sub_pd(_mm_cvtepi32_pd(upper), offset);
+            squaresLow = _mm_add_pd(squaresLow, _mm_mul_pd(low, low));
+            squaresHigh = _mm_add_pd(squaresHigh, _mm_mul_pd(high, high));
+        }
+    }
+
+    alignas(16) int mins[4];
+    alignas(16) int maxs[4];
+    alignas(16) std::int64_t sums[2];
+    alignas(16) double squares[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(mins), minimum);
+    _mm_store_si128(reinterpret_cast<__m128i*>(maxs), maximum);
+    _mm_store_si128(reinterpret_cast<__m128i*>(sums), _mm_add_epi64(sumLow, sumHigh));
+    _mm_store_pd(squares, _mm_add_pd(squaresLow, squaresHigh));
+
+    Summary summary = emptySummary();
+    summary.min = *std::min_element(mins, mins + 4);
+    summary.max = *std::max_element(maxs, maxs + 4);
+    summary.sum = sums[0] + sums[1];
+    summary.shiftedSquares = squares[0] + squares[1];
+    reduceTail<Squares>(summary, values + i, count - i, shift);
+    return summary;
+}
+
+template <bool Squares>
+__attribute__((target("avx2"))) Summary reduceAvx2(const int* values, size_t count, int shift) {
+    __m256i minimum = _mm256_set1_epi32(INT_MAX);
+    __m256i maximum = _mm256_set1_epi32(INT_MIN);
+    __m256i sumLow = _mm256_setzero_si256();
+    __m256i sumHigh = _mm256_setzero_si256();
+    __m256d squaresLow = _mm256_setzero_pd();
+    __m256d squaresHigh = _mm256_setzero_pd();
+    const __m256d offset = _mm256_set1_pd(shift);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        __m128i lower = _mm256_castsi256_si128(v);
+        __m128i upper = _mm256_extracti128_si256(v, 1);
+        minimum = _mm256_min_epi32(minimum, v);
+        maximum = _mm256_max_epi32(maximum, v);
+        sumLow = _mm256_add_epi64(sumLow, _mm256_cvtepi32_epi64(lower));
+        sumHigh = _mm256_add_epi64(sumHigh, _mm256_cvtepi32_epi64(upper));
+        if (Squares) {
+            __m256d low = _mm256_sub_pd(_mm256_cvtepi32_pd(lower), offset);
+            __m256d high = _mm256_sub_pd(_mm256_cvtepi32_pd(upper), offset);
+            squaresLow = _mm256_add_pd(squaresLow, _mm256_mul_pd(low, low));
+            squaresHigh = _mm256_add_pd(squaresHigh, _mm256_mul_pd(high, high));
+        }
+    }
+
+    alignas(32) int mins[8];
+    alignas(32) int maxs[8];
+    alignas(32) std::int64_t sums[4];
+    alignas(32) double squares[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(mins), minimum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(maxs), maximum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(sums), _mm256_add_epi64(sumLow, sumHigh));
+    _mm256_store_pd(squares, _mm256_add_pd(squaresLow, squaresHigh));
+
+    Summary summary = emptySummary();
+    summary.min = *std::min_element(mins, mins + 8);
+    summary.max = *std::max_element(maxs, maxs + 8);
+    summary.sum = sums[0] + sums[1] + sums[2] + sums[3];
+    summary.shiftedSquares = (squares[0] + squares[1]) + (squares[2] + squares[3]);
+    reduceTail<Squares>(summary, values + i, count - i, shift);
+    return summary;
+}
+
+#endif
+
+Isa detectIsa() {
+#ifdef INT_REDUCTIONS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return Isa::Sse41;
+    }
+#endif
+    return Isa::Scalar;
+}
+
+template <bool Squares>
+Summary reduce(Isa isa, const int* values, size_t count, int shift) {
+#ifdef INT_REDUCTIONS_X86
+    if (isa == Isa::Avx2) {
+        return reduceAvx2<Squares>(values, count, shift);
+    }
+    if (isa == Isa::Sse41) {
+        return reduceSse41<Squares>(values, count, shift);
+    }
+#endif
+    return reduceScalar<Squares>(values, count, shift);
+}
+
+const size_t CACHE_LINE_VALUES = 64 / sizeof(int);
+
+void combine(Summary& into, const Summary& part) {
+    into.min = std::min(into.min, part.min);
+    into.max = std::max(into.max, part.max);
+    into.sum += part.sum;
+    into.shiftedSquares += part.shiftedSquares;
+}
+
+template <bool Squares>
+Summary reduceParallel(const int* values, size_t count, int shift, ThreadPool& pool) {
+    const Isa isa = IntReductions::activeIsa();
+    if (count < IntReductions::PARALLEL_THRESHOLD) {
+        return reduce<Squares>(isa, values, count, shift);
+    }
+
+    size_t chunk = (count + IntReductions::MAX_PARALLEL_CHUNKS - 1) / IntReductions::MAX_PARALLEL_CHUNKS;
+    chunk = (chunk + CACHE_LINE_VALUES - 1) / CACHE_LINE_VALUES * CACHE_LINE_VALUES;
+
+    // A worker waiting on its own pool could deadlock, so it reduces the
+    // same chunks itself; the result does not change.
+    Summary summary = emptySummary();
+    if (pool.isWorkerThread()) {
+        for (size_t begin = 0; begin < count; begin += chunk) {
+            combine(summary, reduce<Squares>(isa, values + begin, std::min(chunk, count - begin), shift));
+        }
+        return summary;
+    }
+
+    std::vector<std::future<Summary>> parts;
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        const int* start = values + begin;
+        size_t length = std::min(chunk, count - begin);
+        parts.push_back(pool.submit([isa, start, length, shift]() {
+            return reduce<Squares>(isa, start, length, shift);
+        }));
+    }
+
+    for (auto& part : parts) {
+        combine(summary, part.get());
+    }
+    return summary;
+}
+
+}
+
+namespace IntReductions {
+
+Isa activeIsa() {
+    static const Isa isa = detectIsa();
+    return isa;
+}
+
+bool isSupported(Isa isa) {
+    return static_cast<int>(isa) <= static_cast<int>(activeIsa());
+}
+
+Summary summarize(const int* values, size_t count) {
+    return summarize(activeIsa(), values, count);
+}
+
+Summary summarizeShifted(const int* values, size_t count, int shift) {
+    return summarizeShifted(activeIsa(), values, count, shift);
+}
+
+Summary summarize(Isa isa, const int* values, size_t count) {
+    return reduce<false>(isSupported(isa) ? isa : Isa::Scalar, values, count, 0);
+}
+
+Summary summarizeShifted(Isa isa, const int* values, size_t count, int shift) {
+    return reduce<true>(isSupported(isa) ? isa : Isa::Scalar, values, count, shift);
+}
+
+Summary summarize(const int* values, size_t count, ThreadPool& pool) {
+    return reduceParallel<false>(values, count, 0, pool);
+}
+
+Summary summarizeShifted(const int* values, size_t count, int shift, ThreadPool& pool) {
+    return reduceParallel<true>(values, count, shift, pool);
+}
+
+}
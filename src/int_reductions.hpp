@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+class ThreadPool;
+
+// Min/max/sum reductions over int spans for MathUtils. Sums accumulate in
+// 64 bits. The widest instruction set the CPU supports is chosen once at
+// startup (AVX2, then SSE4.1, then plain C++); the other kernels stay
+// callable so they can be checked against the scalar one.
+namespace IntReductions {
+
+enum class Isa {
+    Scalar,
+    Sse41,
+    Avx2
+};
+
+struct Summary {
+    int min;
+    int max;
+    std::int64_t sum;
+    // Sum of (x - shift)^2, only filled in by summarizeShifted. Shifting by
+    // a sample value keeps the variance from cancelling catastrophically.
+    double shiftedSquares;
+};
+
+Isa activeIsa();
+bool isSupported(Isa isa);
+
+// count must be positive.
+Summary summarize(const int* values, size_t count);
+Summary summarizeShifted(const int* values, size_t count, int shift);
+
+Summary summarize(Isa isa, const int* values, size_t count);
+Summary summarizeShifted(Isa isa, const int* values, size_t count, int shift);
+
+// Spans of at least PARALLEL_THRESHOLD values are cut into chunks whose
+// length is a multiple of a cache line and reduced on the pool. The chunk
+// layout depends only on count and the partial results are folded in
+// chunk order, so the result does not vary with the pool size or timing.
+// Shorter spans are reduced on the calling thread.
+constexpr size_t PARALLEL_THRESHOLD = 1 << 20;
+constexpr size_t MAX_PARALLEL_CHUNKS = 64;
+
+Summary summarize(const int* values, size_t count, ThreadPool& pool);
+Summary summarizeShifted(const int* values, size_t count, int shift, ThreadPool& pool);
+
+}
@@ -1,5 +1,12 @@
 #pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <future>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 class IDatabase {
@@ -12,6 +19,23 @@ public:
     virtual bool exists(const std::string& key) = 0;
 };
 
+// Read-only view of a whole file's bytes, valid for the lifetime of the
+// view object.
+class FileView {
+public:
+    virtual ~FileView() = default;
+    virtual const char* data() const = 0;
+    virtual size_t size() const = 0;
+};
+
+// Metadata used for change detection. A zero modification time means the
+// file system does not track one.
+struct FileInfo {
+    bool exists = false;
+    size_t size = 0;
+    std::int64_t modifiedNanos = 0;
+};
+
 class IFileSystem {
 public:
     virtual ~IFileSystem() = default;
@@ -20,6 +44,86 @@ public:
     virtual bool deleteFile(const std::string& filename) = 0;
     virtual bool fileExists(const std::string& filename) = 0;
     virtual size_t getFileSize(const std::string& filename) = 0;
+
+    // Streaming hooks. The defaults go through readFile/writeFile, so they
+    // work everywhere but load the whole file on each call; implementations
+    // backed by real storage should override them.
+    // True when readChunk/appendChunk touch only the bytes asked for.
+    // Callers only stream files on their own initiative when it is.
+    virtual bool supportsChunkedIo() const {
+        return false;
+    }
+
+    virtual size_t readChunk(const std::string& filename, size_t offset, char* buffer, size_t size) {
+        std::string content = readFile(filename);
+        if (offset >= content.size()) {
+            return 0;
+        }
+        size_t count = std::min(size, content.size() - offset);
+        content.copy(buffer, count, offset);
+        return count;
+    }
+
+    virtual bool appendChunk(const std::string& filename, const char* data, size_t size) {
+        std::string content = fileExists(filename) ? readFile(filename) : std::string();
+        content.append(data, size);
+        return writeFile(filename, content);
+    }
+
+    // Zero-copy access to a file's contents. Returns nullptr when the
+    // implementation cannot provide a view, in which case callers fall back
+    // to readFile/readChunk.
+    virtual std::unique_ptr<FileView> openView(const std::string& filename) {
+        (void)filename;
+        return nullptr;
+    }
+
+    // Whether both names refer to the same file. The default compares the
+    // names; implementations that can see through links should do better.
+    virtual bool isSameFile(const std::string& first, const std::string& second) {
+        return first == second;
+    }
+
+    // Moves source over destination. The default copies and deletes.
+    virtual bool renameFile(const std::string& source, const std::string& destination) {
+        if (!fileExists(source) || !writeFile(destination, readFile(source))) {
+            return false;
+        }
+        return deleteFile(source);
+    }
+
+    virtual FileInfo getFileInfo(const std::string& filename) {
+        FileInfo info;
+        info.exists = fileExists(filename);
+        info.size = info.exists ? getFileSize(filename) : 0;
+        return info;
+    }
+
+    // Replaces destination with a copy of source. Implementations can let
+    // the kernel or the file system copy, or share, the blocks.
+    virtual bool copyFile(const std::string& source, const std::string& destination) {
+        return writeFile(destination, readFile(source));
+    }
+
+    // Overwrites bytes of an existing file in place. Returns false when the
+    // file does not exist or in-place writes are not supported.
+    virtual bool writeChunkAt(const std::string& filename, size_t offset, const char* data, size_t size) {
+        (void)filename;
+        (void)offset;
+        (void)data;
+        (void)size;
+        return false;
+    }
+};
+
+// Non-blocking counterpart of IFileSystem's whole-file calls. A read that
+// cannot open its file fails its future with std::runtime_error; a failed
+// write yields false.
+class IAsyncFileSystem {
+public:
+    virtual ~IAsyncFileSystem() = default;
+    virtual std::future<std::string> readFileAsync(const std::string& filename) = 0;
+    virtual std::future<bool> writeFileAsync(const std::string& filename, std::string content) = 0;
 };
 
 class INetworkClient {
@@ -31,6 +135,40 @@ public:
     virtual void setTimeout(int seconds) = 0;
 };
 
+enum class LogLevel {
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+namespace LogFormat {
+
+inline void append(std::string& out, std::string_view text) {
+    out.append(text.data(), text.size());
+}
+
+inline void append(std::string& out, const char* text) {
+    out.append(text);
+}
+
+inline void append(std::string& out, char c) {
+    out.push_back(c);
+}
+
+inline void append(std::string& out, bool value) {
+    append(out, value ? std::string_view("true") : std::string_view("false"));
+}
+
+template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+void append(std::string& out, T value) {
+    char digits[32];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+}
+
 class ILogger {
 public:
     virtual ~ILogger() = default;
@@ -38,4 +176,49 @@ public:
     virtual void warning(const std::string& message) = 0;
     virtual void error(const std::string& message) = 0;
     virtual void debug(const std::string& message) = 0;
+
+    // Loggers that discard some levels should say so here, so that callers
+    // skip building messages nobody will read.
+    virtual bool isEnabled(LogLevel level) const {
+        (void)level;
+        return true;
+    }
+
+    // Hands a message to the method for its level.
+    virtual void write(LogLevel level, const std::string& message) {
+        switch (level) {
+        case LogLevel::Debug:
+            debug(message);
+            break;
+        case LogLevel::Info:
+            info(message);
+            break;
+        case LogLevel::Warning:
+            warning(message);
+            break;
+        case LogLevel::Error:
+            error(message);
+            break;
+        }
+    }
+
+    // Concatenates strings, characters and numbers into one message, but
+    // only when the level is enabled.
+    template <typename... Args>
+    void log(LogLevel level, const Args&... args) {
+        if (!isEnabled(level)) {
+            return;
+        }
+        std::string message;
+        (LogFormat::append(message, args), ...);
+        write(level, message);
+    }
+
+    // Calls format() for the message only when the level is enabled.
+    template <typename Format>
+    void logLazy(LogLevel level, Format&& format) {
+        if (isEnabled(level)) {
+            write(level, format());
+        }
+    }
 };
\ No newline at end of file
@@ -0,0 +1,183 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+// Compile-time versions of MathUtils' integer functions. They are usable
+// in constant expressions, where an error that would throw at run time
+// becomes a compile error instead. The out-of-line MathUtils functions
+// share these implementations.
+namespace MathUtils {
+namespace ct {
+
+constexpr int add(int a, int b) {
+    return a + b;
+}
+
+constexpr int multiply(int a, int b) {
+    return a * b;
+}
+
+constexpr int MAX_UINT64_FACTORIAL = 20;
+
+constexpr std::array<std::uint64_t, MAX_UINT64_FACTORIAL + 1> makeFactorialTable() {
+    std::array<std::uint64_t, MAX_UINT64_FACTORIAL + 1> table{};
+    table[0] = 1;
+    for (int i = 1; i <= MAX_UINT64_FACTORIAL; ++i) {
+        table[i] = table[i - 1] * static_cast<std::uint64_t>(i);
+    }
+    return table;
+}
+
+inline constexpr std::array<std::uint64_t, MAX_UINT64_FACTORIAL + 1> FACTORIALS = makeFactorialTable();
+
+// n! as T; throws overflow_error when it does not fit.
+template <typename T = std::uint64_t>
+constexpr T factorial(int n) {
+    static_assert(std::is_integral<T>::value, "factorial requires an integer type");
+    if (n < 0) {
+        throw std::invalid_argument("Factorial of negative number");
+    }
+    if (n > MAX_UINT64_FACTORIAL ||
+        FACTORIALS[n] > static_cast<std::uint64_t>(std::numeric_limits<T>::max())) {
+        throw std::overflow_error("Factorial result overflows");
+    }
+    return static_cast<T>(FACTORIALS[n]);
+}
+
+// Exponentiation by squaring. Returns false if the result does not fit in
+// T; the base is only squared while bits of the exponent remain, so a
+// square that overflows always means the result would too.
+template <typename T>
+constexpr bool tryPower(T base, int exponent, T& result) {
+    static_assert(std::is_integral<T>::value, "power requires an integer type");
+    T value = 1;
+    while (exponent > 0) {
+        if ((exponent & 1) && __builtin_mul_overflow(value, base, &value)) {
+            return false;
+        }
+        exponent >>= 1;
+        if (exponent > 0 && __builtin_mul_overflow(base, base, &base)) {
+            return false;
+        }
+    }
+    result = value;
+    return true;
+}
+
+template <typename T>
+constexpr T power(T base, int exponent) {
+    if (exponent < 0) {
+        throw std::invalid_argument("Negative exponent not supported");
+    }
+    T result = 0;
+    if (!tryPower(base, exponent, result)) {
+        throw std::overflow_error("Power result overflows");
+    }
+    return result;
+}
+
+#if defined(__SIZEOF_INT128__)
+// __extension__ keeps -Wpedantic quiet about the non-standard type.
+__extension__ typedef unsigned __int128 UInt128;
+
+constexpr std::uint64_t mulmod(std::uint64_t a, std::uint64_t b, std::uint64_t modulus) {
+    return static_cast<std::uint64_t>(static_cast<UInt128>(a) * b % modulus);
+}
+#else
+// Double-and-add, so no intermediate exceeds 64 bits.
+constexpr std::uint64_t mulmod(std::uint64_t a, std::uint64_t b, std::uint64_t modulus) {
+    a %= modulus;
+    b %= modulus;
+    std::uint64_t result = 0;
+    while (b > 0) {
+        if (b & 1) {
+            result = result >= modulus - a ? result - (modulus - a) : result + a;
+        }
+        a = a >= modulus - a ? a - (modulus - a) : a + a;
+        b >>= 1;
+    }
+    return result;
+}
+#endif
+
+constexpr std::uint64_t powmod(std::uint64_t base, std::uint64_t exponent, std::uint64_t modulus) {
+    if (modulus == 0) {
+        throw std::invalid_argument("Modulus must be positive");
+    }
+    std::uint64_t result = 1 % modulus;
+    base %= modulus;
+    while (exponent > 0) {
+        if (exponent & 1) {
+            result = mulmod(result, base, modulus);
+        }
+        exponent >>= 1;
+        if (exponent > 0) {
+            base = mulmod(base, base, modulus);
+        }
+    }
+    return result;
+}
+
+// Deterministic for every 64-bit input with the first twelve prime bases.
+constexpr bool millerRabin(std::uint64_t n) {
+    constexpr std::uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    if (n < 2) {
+        return false;
+    }
+    for (std::uint64_t p : bases) {
+        if (n % p == 0) {
+            return n == p;
+        }
+    }
+
+    std::uint64_t d = n - 1;
+    int shifts = 0;
+    while (d % 2 == 0) {
+        d /= 2;
+        ++shifts;
+    }
+
+    for (std::uint64_t a : bases) {
+        std::uint64_t x = powmod(a, d, n);
+        if (x == 1 || x == n - 1) {
+            continue;
+        }
+        bool witness = true;
+        for (int r = 1; r < shifts; ++r) {
+            x = mulmod(x, x, n);
+            if (x == n - 1) {
+                witness = false;
+                break;
+            }
+        }
+        if (witness) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Trial division by 6k +/- 1 for small inputs, Miller-Rabin above that.
+constexpr bool isPrime(std::int64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    if (n >= (1 << 20)) {
+        return millerRabin(static_cast<std::uint64_t>(n));
+    }
+    if (n % 2 == 0 || n % 3 == 0) {
+        return n < 4;
+    }
+    for (std::int64_t i = 5; i * i <= n; i += 6) {
+        if (n % i == 0 || n % (i + 2) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+}
@@ -1,16 +1,219 @@
 #include "math_utils.hpp"
+#include "int_reductions.hpp"
+#include "math_constexpr.hpp"
+#include "prime_sieve.hpp"
+#include "thread_pool.hpp"
 #include <algorithm>
+#include <array>
+#include <limits>
 #include <numeric>
 #include <stdexcept>
+#include <string_view>
+
+namespace {
+
+const int MAX_INT_FACTORIAL = 12;
+const int MAX_UINT64_FACTORIAL = MathUtils::ct::MAX_UINT64_FACTORIAL;
+
+const auto& FACTORIALS = MathUtils::ct::FACTORIALS;
+
+void requireNonNegative(int n) {
+    if (n < 0) {
+        throw std::invalid_argument("Factorial of negative number");
+    }
+}
+
+// Arbitrary-precision unsigned integers as little-endian base-10^9 limbs,
+// just enough arithmetic for bigFactorial. The decimal base makes the
+// final conversion to a string linear instead of quadratic.
+using Limbs = std::vector<std::uint32_t>;
+
+const std::uint64_t LIMB_BASE = 1000000000;
+const size_t KARATSUBA_THRESHOLD = 32;
+const int PRODUCT_TREE_LEAF = 16;
+
+void trim(Limbs& value) {
+    while (!value.empty() && value.back() == 0) {
+        value.pop_back();
+    }
+}
+
+void multiplySmall(Limbs& value, std::uint32_t factor) {
+    std::uint64_t carry = 0;
+    for (auto& limb : value) {
+        std::uint64_t product = static_cast<std::uint64_t>(limb) * factor + carry;
+        limb = static_cast<std::uint32_t>(product % LIMB_BASE);
+        carry = product / LIMB_BASE;
+    }
+    while (carry) {
+        value.push_back(static_cast<std::uint32_t>(carry % LIMB_BASE));
+        carry /= LIMB_BASE;
+    }
+}
+
+Limbs schoolbookMultiply(const Limbs& a, const Limbs& b) {
+    Limbs result(a.size() + b.size(), 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        std::uint64_t carry = 0;
+        for (size_t j = 0; j < b.size(); ++j) {
+            std::uint64_t t = static_cast<std::uint64_t>(a[i]) * b[j] + result[i + j] + carry;
+            result[i + j] = static_cast<std::uint32_t>(t % LIMB_BASE);
+            carry = t / LIMB_BASE;
+        }
+        result[i + b.size()] = static_cast<std::uint32_t>(carry);
+    }
+    trim(result);
+    return result;
+}
+
+// target += value * LIMB_BASE^shift
+void addShifted(Limbs& target, const Limbs& value, size_t shift) {
+    if (target.size() < value.size() + shift) {
+        target.resize(value.size() + shift, 0);
+    }
+    std::uint32_t carry = 0;
+    size_t i = 0;
+    for (; i < value.size(); ++i) {
+        std::uint32_t sum = target[i + shift] + value[i] + carry;
+        carry = sum >= LIMB_BASE;
+        target[i + shift] = carry ? sum - static_cast<std::uint32_t>(LIMB_BASE) : sum;
+    }
+    for (i += shift; carry && i < target.size(); ++i) {
+        std::uint32_t sum = target[i] + carry;
+        carry = sum >= LIMB_BASE;
+        target[i] = carry ? sum - static_cast<std::uint32_t>(LIMB_BASE) : sum;
+    }
+    if (carry) {
+        target.push_back(carry);
+    }
+}
+
+// target -= value; the caller guarantees target >= value.
+void subtractInPlace(Limbs& target, const Limbs& value) {
+    std::int64_t borrow = 0;
+    for (size_t i = 0; i < target.size(); ++i) {
+        std::int64_t difference = static_cast<std::int64_t>(target[i]) - borrow -
+                                  (i < value.size() ? static_cast<std::int64_t>(value[i]) : 0);
+        borrow = difference < 0;
+        target[i] = static_cast<std::uint32_t>(borrow ? difference + static_cast<std::int64_t>(LIMB_BASE) : difference);
+    }
+    trim(target);
+}
+
+Limbs multiply(const Limbs& a, const Limbs& b);
+
+Limbs karatsubaMultiply(const Limbs& a, const Limbs& b) {
+    size_t half = std::max(a.size(), b.size()) / 2;
+    Limbs a0(a.begin(), a.begin() + half);
+    Limbs a1(a.begin() + half, a.end());
+    Limbs b0(b.begin(), b.begin() + half);
+    Limbs b1(b.begin() + half, b.end());
+    trim(a0);
+    trim(b0);
+
+    Limbs z0 = multiply(a0, b0);
+    Limbs z2 = multiply(a1, b1);
+
+    Limbs aSum = a0;
+    addShifted(aSum, a1, 0);
+    Limbs bSum = b0;
+    addShifted(bSum, b1, 0);
+    Limbs z1 = multiply(aSum, bSum);
+    subtractInPlace(z1, z0);
+    subtractInPlace(z1, z2);
+
+    Limbs result = z0;
+    addShifted(result, z1, half);
+    addShifted(result, z2, 2 * half);
+    trim(result);
+    return result;
+}
+
+Limbs multiply(const Limbs& a, const Limbs& b) {
+    if (a.empty() || b.empty()) {
+        return Limbs();
+    }
+    size_t smaller = std::min(a.size(), b.size());
+    size_t larger = std::max(a.size(), b.size());
+    if (smaller < KARATSUBA_THRESHOLD || smaller <= larger / 2) {
+        return schoolbookMultiply(a, b);
+    }
+    return karatsubaMultiply(a, b);
+}
+
+// Product of all integers in [low, high]. Splitting the range in half keeps
+// both operands of every multiplication about the same size, which is what
+// lets Karatsuba pay off.
+Limbs productRange(int low, int high) {
+    if (high - low < PRODUCT_TREE_LEAF) {
+        Limbs result{1};
+        for (int i = low; i <= high; ++i) {
+            multiplySmall(result, static_cast<std::uint32_t>(i));
+        }
+        return result;
+    }
+    int middle = low + (high - low) / 2;
+    return multiply(productRange(low, middle), productRange(middle + 1, high));
+}
+
+std::string toDecimal(const Limbs& value) {
+    if (value.empty()) {
+        return "0";
+    }
+    std::string result = std::to_string(value.back());
+    for (size_t i = value.size() - 1; i-- > 0;) {
+        std::string digits = std::to_string(value[i]);
+        result.append(9 - digits.size(), '0');
+        result += digits;
+    }
+    return result;
+}
+
+constexpr std::array<std::string_view, 20> ONES = {
+    "zero", "one", "two", "three", "four", "five", "six", "seven", "eight", "nine",
+    "ten", "eleven", "twelve", "thirteen", "fourteen", "fifteen",
+    "sixteen", "seventeen", "eighteen", "nineteen"
+};
+
+constexpr std::array<std::string_view, 10> TENS = {
+    "", "", "twenty", "thirty", "forty", "fifty", "sixty", "seventy", "eighty", "ninety"
+};
+
+constexpr std::array<std::string_view, 7> SCALES = {
+    "", "thousand", "million", "billion", "trillion", "quadrillion", "quintillion"
+};
+
+void requireValues(size_t count, const char* message) {
+    if (count == 0) {
+        throw std::invalid_argument(message);
+    }
+}
+
+MathUtils::Stats toStats(const IntReductions::Summary& summary, size_t count, int shift) {
+    const double n = static_cast<double>(count);
+    const std::int64_t shiftedSum = summary.sum - static_cast<std::int64_t>(shift) * static_cast<std::int64_t>(count);
+    const double shiftedMean = static_cast<double>(shiftedSum) / n;
+
+    MathUtils::Stats stats;
+    stats.min = summary.min;
+    stats.max = summary.max;
+    stats.sum = summary.sum;
+    stats.mean = static_cast<double>(summary.sum) / n;
+    stats.variance = std::max(0.0, summary.shiftedSquares / n - shiftedMean * shiftedMean);
+    stats.count = count;
+    return stats;
+}
+
+}
 
 namespace MathUtils {
 
 int add(int a, int b) {
-    return a + b;
+    return ct::add(a, b);
 }
 
 int multiply(int a, int b) {
-    return a * b;
+    return ct::multiply(a, b);
 }
 
 double divide(double a, double b) {
@@ -21,89 +224,220 @@ double divide(double a, double b) {
 }
 
 int factorial(int n) {
-    if (n < 0) {
-        throw std::invalid_argument("Factorial of negative number");
+    requireNonNegative(n);
+    if (n > MAX_INT_FACTORIAL) {
+        throw std::overflow_error("Factorial result overflows int");
     }
-    if (n == 0 || n == 1) {
-        return 1;
+    return static_cast<int>(FACTORIALS[n]);
+}
+
+std::uint64_t factorial64(int n) {
+    requireNonNegative(n);
+    if (n > MAX_UINT64_FACTORIAL) {
+        throw std::overflow_error("Factorial result overflows 64-bit integer");
     }
-    int result = 1;
-    for (int i = 2; i <= n; ++i) {
-        result *= i;
+    return FACTORIALS[n];
+}
+
+std::optional<std::uint64_t> checkedFactorial(int n) {
+    requireNonNegative(n);
+    if (n > MAX_UINT64_FACTORIAL) {
+        return std::nullopt;
     }
-    return result;
+    return FACTORIALS[n];
+}
+
+std::string bigFactorial(int n) {
+    requireNonNegative(n);
+    if (n <= MAX_UINT64_FACTORIAL) {
+        return std::to_string(FACTORIALS[n]);
+    }
+    return toDecimal(productRange(2, n));
 }
 
 bool isPrime(int n) {
     if (n < 2) return false;
-    if (n == 2) return true;
-    if (n % 2 == 0) return false;
-    
-    for (int i = 3; i * i <= n; i += 2) {
-        if (n % i == 0) return false;
-    }
-    return true;
+    return PrimeSieve::instance().isPrime(static_cast<std::uint64_t>(n));
+}
+
+bool isPrime64(std::uint64_t n) {
+    return PrimeSieve::instance().isPrime(n);
+}
+
+std::uint64_t countPrimes(std::uint64_t low, std::uint64_t high) {
+    return PrimeSieve::instance().countInRange(low, high, ThreadPool::shared());
+}
+
+std::vector<std::uint64_t> primesInRange(std::uint64_t low, std::uint64_t high) {
+    return PrimeSieve::instance().primesInRange(low, high, ThreadPool::shared());
 }
 
 int findMax(const std::vector<int>& numbers) {
-    if (numbers.empty()) {
-        throw std::invalid_argument("Cannot find max of empty vector");
-    }
-    return *std::max_element(numbers.begin(), numbers.end());
+    return findMax(numbers.data(), numbers.size());
+}
+
+int findMax(const int* numbers, size_t count) {
+    requireValues(count, "Cannot find max of empty vector");
+    return IntReductions::summarize(numbers, count).max;
+}
+
+int findMax(const std::vector<int>& numbers, ThreadPool& pool) {
+    return findMax(numbers.data(), numbers.size(), pool);
+}
+
+int findMax(const int* numbers, size_t count, ThreadPool& pool) {
+    requireValues(count, "Cannot find max of empty vector");
+    return IntReductions::summarize(numbers, count, pool).max;
+}
+
+int findMin(const std::vector<int>& numbers) {
+    return findMin(numbers.data(), numbers.size());
+}
+
+int findMin(const int* numbers, size_t count) {
+    requireValues(count, "Cannot find min of empty vector");
+    return IntReductions::summarize(numbers, count).min;
+}
+
+int findMin(const std::vector<int>& numbers, ThreadPool& pool) {
+    return findMin(numbers.data(), numbers.size(), pool);
+}
+
+int findMin(const int* numbers, size_t count, ThreadPool& pool) {
+    requireValues(count, "Cannot find min of empty vector");
+    return IntReductions::summarize(numbers, count, pool).min;
+}
+
+std::int64_t sum(const std::vector<int>& numbers) {
+    return sum(numbers.data(), numbers.size());
+}
+
+std::int64_t sum(const int* numbers, size_t count) {
+    return count == 0 ? 0 : IntReductions::summarize(numbers, count).sum;
+}
+
+std::int64_t sum(const std::vector<int>& numbers, ThreadPool& pool) {
+    return sum(numbers.data(), numbers.size(), pool);
+}
+
+std::int64_t sum(const int* numbers, size_t count, ThreadPool& pool) {
+    return count == 0 ? 0 : IntReductions::summarize(numbers, count, pool).sum;
 }
 
 double average(const std::vector<int>& numbers) {
-    if (numbers.empty()) {
-        throw std::invalid_argument("Cannot calculate average of empty vector");
-    }
-    int sum = std::accumulate(numbers.begin(), numbers.end(), 0);
-    return static_cast<double>(sum) / numbers.size();
+    return average(numbers.data(), numbers.size());
+}
+
+double average(const int* numbers, size_t count) {
+    requireValues(count, "Cannot calculate average of empty vector");
+    return static_cast<double>(sum(numbers, count)) / count;
+}
+
+double average(const std::vector<int>& numbers, ThreadPool& pool) {
+    return average(numbers.data(), numbers.size(), pool);
+}
+
+double average(const int* numbers, size_t count, ThreadPool& pool) {
+    requireValues(count, "Cannot calculate average of empty vector");
+    return static_cast<double>(sum(numbers, count, pool)) / count;
+}
+
+Stats computeStats(const std::vector<int>& numbers) {
+    return computeStats(numbers.data(), numbers.size());
+}
+
+Stats computeStats(const int* numbers, size_t count) {
+    requireValues(count, "Cannot compute stats of empty vector");
+    return toStats(IntReductions::summarizeShifted(numbers, count, numbers[0]), count, numbers[0]);
+}
+
+Stats computeStats(const std::vector<int>& numbers, ThreadPool& pool) {
+    return computeStats(numbers.data(), numbers.size(), pool);
+}
+
+Stats computeStats(const int* numbers, size_t count, ThreadPool& pool) {
+    requireValues(count, "Cannot compute stats of empty vector");
+    return toStats(IntReductions::summarizeShifted(numbers, count, numbers[0], pool), count, numbers[0]);
 }
 
 int power(int base, int exponent) {
     if (exponent < 0) {
         throw std::invalid_argument("Negative exponent not supported");
     }
-    if (exponent == 0) {
-        return 1;
-    }
-    
-    int result = 1;
-    for (int i = 0; i < exponent; ++i) {
-        result *= base;
+    int result = 0;
+    if (!ct::tryPower(base, exponent, result)) {
+        throw std::overflow_error("Power result overflows int");
     }
     return result;
 }
 
-std::string numberToWords(int n) {
-    if (n < 0 || n > 99) {
-        throw std::invalid_argument("Only numbers 0-99 supported");
+std::int64_t power64(std::int64_t base, int exponent) {
+    if (exponent < 0) {
+        throw std::invalid_argument("Negative exponent not supported");
     }
-    
-    const std::vector<std::string> ones = {
-        "zero", "one", "two", "three", "four", "five", "six", "seven", "eight", "nine"
-    };
-    
-    const std::vector<std::string> teens = {
-        "ten", "eleven", "twelve", "thirteen", "fourteen", "fifteen", 
-        "sixteen", "seventeen", "eighteen", "nineteen"
-    };
-    
-    const std::vector<std::string> tens = {
-        "", "", "twenty", "thirty", "forty", "fifty", "sixty", "seventy", "eighty", "ninety"
+    std::int64_t result = 0;
+    if (!ct::tryPower(base, exponent, result)) {
+        throw std::overflow_error("Power result overflows 64-bit integer");
+    }
+    return result;
+}
+
+std::uint64_t powmod(std::uint64_t base, std::uint64_t exponent, std::uint64_t modulus) {
+    return ct::powmod(base, exponent, modulus);
+}
+
+void numberToWords(std::int64_t n, std::string& out) {
+    // Longest spelling is well under 256 characters, so words are composed
+    // on the stack and appended in one step.
+    char buffer[256];
+    size_t length = 0;
+    auto append = [&](std::string_view word) {
+        if (length > 0) {
+            buffer[length++] = ' ';
+        }
+        word.copy(buffer + length, word.size());
+        length += word.size();
     };
-    
-    if (n < 10) {
-        return ones[n];
-    } else if (n < 20) {
-        return teens[n - 10];
-    } else {
-        std::string result = tens[n / 10];
-        if (n % 10 != 0) {
-            result += " " + ones[n % 10];
+
+    if (n == 0) {
+        out.append(ONES[0]);
+        return;
+    }
+    if (n < 0) {
+        append("minus");
+    }
+    std::uint64_t magnitude = n < 0 ? 0 - static_cast<std::uint64_t>(n) : static_cast<std::uint64_t>(n);
+
+    std::uint64_t divisor = 1000000000000000000ULL;
+    for (size_t scale = SCALES.size(); scale-- > 0; divisor /= 1000) {
+        unsigned group = static_cast<unsigned>(magnitude / divisor);
+        magnitude %= divisor;
+        if (group == 0) {
+            continue;
+        }
+        if (group >= 100) {
+            append(ONES[group / 100]);
+            append("hundred");
+            group %= 100;
+        }
+        if (group >= 20) {
+            append(TENS[group / 10]);
+            group %= 10;
+        }
+        if (group > 0) {
+            append(ONES[group]);
+        }
+        if (scale > 0) {
+            append(SCALES[scale]);
         }
-        return result;
     }
+    out.append(buffer, length);
 }
 
-}
\ No newline at end of file
+std::string numberToWords(std::int64_t n) {
+    std::string result;
+    numberToWords(n, result);
+    return result;
+}
+
+}
@@ -1,9 +1,25 @@
 #pragma once
+#include <cstdint>
+#include <optional>
 #include <stdexcept>
 #include <vector>
 #include <string>
 
+class ThreadPool;
+
+// Out-of-line MathUtils API. Header-only constexpr equivalents of the
+// integer functions live in math_constexpr.hpp under MathUtils::ct.
 namespace MathUtils {
+
+// Population statistics over a set of ints, gathered in one pass.
+struct Stats {
+    int min;
+    int max;
+    std::int64_t sum;
+    double mean;
+    double variance;
+    size_t count;
+};
     
 int add(int a, int b);
 
@@ -13,14 +29,59 @@ double divide(double a, double b);
 
 int factorial(int n);
 
+std::uint64_t factorial64(int n);
+
+std::optional<std::uint64_t> checkedFactorial(int n);
+
+std::string bigFactorial(int n);
+
 bool isPrime(int n);
 
+bool isPrime64(std::uint64_t n);
+
+std::uint64_t countPrimes(std::uint64_t low, std::uint64_t high);
+
+std::vector<std::uint64_t> primesInRange(std::uint64_t low, std::uint64_t high);
+
 int findMax(const std::vector<int>& numbers);
+int findMax(const int* numbers, size_t count);
+
+int findMin(const std::vector<int>& numbers);
+int findMin(const int* numbers, size_t count);
+
+std::int64_t sum(const std::vector<int>& numbers);
+std::int64_t sum(const int* numbers, size_t count);
 
 double average(const std::vector<int>& numbers);
+double average(const int* numbers, size_t count);
+
+Stats computeStats(const std::vector<int>& numbers);
+Stats computeStats(const int* numbers, size_t count);
+
+// Overloads that spread inputs of IntReductions::PARALLEL_THRESHOLD values
+// or more across the pool. Results are identical for every pool size.
+int findMax(const std::vector<int>& numbers, ThreadPool& pool);
+int findMax(const int* numbers, size_t count, ThreadPool& pool);
+int findMin(const std::vector<int>& numbers, ThreadPool& pool);
+int findMin(const int* numbers, size_t count, ThreadPool& pool);
+std::int64_t sum(const std::vector<int>& numbers, ThreadPool& pool);
+std::int64_t sum(const int* numbers, size_t count, ThreadPool& pool);
+double average(const std::vector<int>& numbers, ThreadPool& pool);
+double average(const int* numbers, size_t count, ThreadPool& pool);
+Stats computeStats(const std::vector<int>& numbers, ThreadPool& pool);
+Stats computeStats(const int* numbers, size_t count, ThreadPool& pool);
 
 int power(int base, int exponent);
 
-std::string numberToWords(int n);
+std::int64_t power64(std::int64_t base, int exponent);
+
+// (base ^ exponent) % modulus with 128-bit intermediates.
+std::uint64_t powmod(std::uint64_t base, std::uint64_t exponent, std::uint64_t modulus);
+
+// English words with spaces between them, e.g. "minus one hundred twenty three".
+std::string numberToWords(std::int64_t n);
+
+// Appends the words to out; no allocation once out has the capacity.
+void numberToWords(std::int64_t n, std::string& out);
 
 }
\ No newline at end of file
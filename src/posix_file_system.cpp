@@ -0,0 +1,251 @@
+#include "posix_file_system.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+namespace {
+
+// Closes the descriptor when it goes out of scope.
+class FileDescriptor {
+private:
+    int fd;
+
+public:
+    explicit FileDescriptor(int descriptor) : fd(descriptor) {}
+    ~FileDescriptor() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    int get() const { return fd; }
+    bool valid() const { return fd >= 0; }
+};
+
+class MappedFileView : public FileView {
+private:
+    void* address;
+    size_t length;
+
+public:
+    MappedFileView(void* mapped, size_t size) : address(mapped), length(size) {}
+    ~MappedFileView() override {
+        if (length > 0) {
+            ::munmap(address, length);
+        }
+    }
+
+    MappedFileView(const MappedFileView&) = delete;
+    MappedFileView& operator=(const MappedFileView&) = delete;
+
+    const char* data() const override { return static_cast<const char*>(address); }
+    size_t size() const override { return length; }
+};
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool writeAllAt(int fd, const char* data, size_t size, size_t offset) {
+    while (size > 0) {
+        ssize_t written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Copies size bytes between descriptors positioned at zero, in the kernel
+// when copy_file_range is available and through a buffer otherwise.
+bool copyRange(int in, int out, size_t size) {
+    size_t copied = 0;
+#if defined(__linux__)
+    while (copied < size) {
+        ssize_t count = ::copy_file_range(in, nullptr, out, nullptr, size - copied, 0);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        copied += static_cast<size_t>(count);
+    }
+    if (copied == size) {
+        return true;
+    }
+#endif
+
+    const size_t bufferSize = 64 * 1024;
+    std::unique_ptr<char[]> buffer(new char[bufferSize]);
+    while (copied < size) {
+        ssize_t count = ::pread(in, buffer.get(), std::min(bufferSize, size - copied), static_cast<off_t>(copied));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0 || !writeAllAt(out, buffer.get(), static_cast<size_t>(count), copied)) {
+            return false;
+        }
+        copied += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+}
+
+bool PosixFileSystem::writeFile(const std::string& filename, const std::string& content) {
+    FileDescriptor fd(::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+    return fd.valid() && writeAll(fd.get(), content.data(), content.size());
+}
+
+std::string PosixFileSystem::readFile(const std::string& filename) {
+    std::string content(getFileSize(filename), '\0');
+    content.resize(readChunk(filename, 0, &content[0], content.size()));
+    return content;
+}
+
+bool PosixFileSystem::deleteFile(const std::string& filename) {
+    return ::unlink(filename.c_str()) == 0;
+}
+
+bool PosixFileSystem::fileExists(const std::string& filename) {
+    struct stat info;
+    return ::stat(filename.c_str(), &info) == 0 && S_ISREG(info.st_mode);
+}
+
+size_t PosixFileSystem::getFileSize(const std::string& filename) {
+    struct stat info;
+    if (::stat(filename.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        return 0;
+    }
+    return static_cast<size_t>(info.st_size);
+}
+
+bool PosixFileSystem::supportsChunkedIo() const {
+    return true;
+}
+
+size_t PosixFileSystem::readChunk(const std::string& filename, size_t offset, char* buffer, size_t size) {
+    FileDescriptor fd(::open(filename.c_str(), O_RDONLY | O_CLOEXEC));
+    if (!fd.valid()) {
+        return 0;
+    }
+    size_t total = 0;
+    while (total < size) {
+        ssize_t count = ::pread(fd.get(), buffer + total, size - total, static_cast<off_t>(offset + total));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        total += static_cast<size_t>(count);
+    }
+    return total;
+}
+
+bool PosixFileSystem::appendChunk(const std::string& filename, const char* data, size_t size) {
+    FileDescriptor fd(::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644));
+    return fd.valid() && writeAll(fd.get(), data, size);
+}
+
+std::unique_ptr<FileView> PosixFileSystem::openView(const std::string& filename) {
+    FileDescriptor fd(::open(filename.c_str(), O_RDONLY | O_CLOEXEC));
+    struct stat info;
+    if (!fd.valid() || ::fstat(fd.get(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size == 0) {
+        return std::make_unique<MappedFileView>(nullptr, 0);
+    }
+
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+    if (mapped == MAP_FAILED) {
+        return nullptr;
+    }
+    ::madvise(mapped, size, MADV_SEQUENTIAL);
+    return std::make_unique<MappedFileView>(mapped, size);
+}
+
+bool PosixFileSystem::isSameFile(const std::string& first, const std::string& second) {
+    struct stat firstInfo;
+    struct stat secondInfo;
+    return ::stat(first.c_str(), &firstInfo) == 0 && ::stat(second.c_str(), &secondInfo) == 0 &&
+           firstInfo.st_dev == secondInfo.st_dev && firstInfo.st_ino == secondInfo.st_ino;
+}
+
+bool PosixFileSystem::renameFile(const std::string& source, const std::string& destination) {
+    return ::rename(source.c_str(), destination.c_str()) == 0;
+}
+
+FileInfo PosixFileSystem::getFileInfo(const std::string& filename) {
+    FileInfo result;
+    struct stat info;
+    if (::stat(filename.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        return result;
+    }
+    result.exists = true;
+    result.size = static_cast<size_t>(info.st_size);
+#if defined(__APPLE__)
+    const struct timespec& modified = info.st_mtimespec;
+#else
+    const struct timespec& modified = info.st_mtim;
+#endif
+    result.modifiedNanos = static_cast<std::int64_t>(modified.tv_sec) * 1000000000 + modified.tv_nsec;
+    return result;
+}
+
+bool PosixFileSystem::copyFile(const std::string& source, const std::string& destination) {
+    FileDescriptor in(::open(source.c_str(), O_RDONLY | O_CLOEXEC));
+    struct stat info;
+    if (!in.valid() || ::fstat(in.get(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        return false;
+    }
+    FileDescriptor out(::open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+    if (!out.valid()) {
+        return false;
+    }
+#if defined(__linux__) && defined(FICLONE)
+    if (::ioctl(out.get(), FICLONE, in.get()) == 0) {
+        return true;
+    }
+#endif
+    return copyRange(in.get(), out.get(), static_cast<size_t>(info.st_size));
+}
+
+bool PosixFileSystem::writeChunkAt(const std::string& filename, size_t offset, const char* data, size_t size) {
+    FileDescriptor fd(::open(filename.c_str(), O_WRONLY | O_CLOEXEC));
+    return fd.valid() && writeAllAt(fd.get(), data, size, offset);
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "interfaces.hpp"
+
+// IFileSystem over POSIX file descriptors. Chunked reads use pread,
+// appends use O_APPEND writes, and openView maps the file read-only so
+// callers can work straight from the page cache. On Linux copyFile tries
+// a reflink first and then copy_file_range, so data stays in the kernel;
+// elsewhere it copies through a buffer.
+class PosixFileSystem : public IFileSystem {
+public:
+    bool writeFile(const std::string& filename, const std::string& content) override;
+    std::string readFile(const std::string& filename) override;
+    bool deleteFile(const std::string& filename) override;
+    bool fileExists(const std::string& filename) override;
+    size_t getFileSize(const std::string& filename) override;
+
+    bool supportsChunkedIo() const override;
+    size_t readChunk(const std::string& filename, size_t offset, char* buffer, size_t size) override;
+    bool appendChunk(const std::string& filename, const char* data, size_t size) override;
+    std::unique_ptr<FileView> openView(const std::string& filename) override;
+
+    bool isSameFile(const std::string& first, const std::string& second) override;
+    bool renameFile(const std::string& source, const std::string& destination) override;
+    FileInfo getFileInfo(const std::string& filename) override;
+    bool copyFile(const std::string& source, const std::string& destination) override;
+    bool writeChunkAt(const std::string& filename, size_t offset, const char* data, size_t size) override;
+};
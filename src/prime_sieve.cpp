@@ -0,0 +1,270 @@
+#include "prime_sieve.hpp"
+#include "math_constexpr.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <mutex>
+
+namespace {
+
+const std::uint64_t SEGMENT_SPAN = 1 << 16;
+
+std::uint64_t integerSqrt(std::uint64_t n) {
+    std::uint64_t root = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n)));
+    while (root > 0 && root > n / root) {
+        --root;
+    }
+    while (root + 1 <= n / (root + 1)) {
+        ++root;
+    }
+    return root;
+}
+
+// Calls visit(p) for every prime p in [low, high] in increasing order.
+// With base primes up to sqrt(high) the range is sieved one cache-sized
+// segment at a time; without them each odd candidate is tested with
+// Miller-Rabin.
+template <typename Visit>
+void visitPrimes(std::uint64_t low, std::uint64_t high, const std::vector<std::uint32_t>* basePrimes, Visit&& visit) {
+    if (low <= 2 && 2 <= high) {
+        visit(std::uint64_t(2));
+    }
+    low = std::max<std::uint64_t>(low, 3);
+    if (low > high) {
+        return;
+    }
+
+    if (!basePrimes) {
+        for (std::uint64_t n = low | 1; n <= high; n += 2) {
+            if (PrimeSieve::millerRabin(n)) {
+                visit(n);
+            }
+            if (high - n < 2) {
+                break;
+            }
+        }
+        return;
+    }
+
+    std::vector<std::uint8_t> candidate;
+    for (std::uint64_t segmentLow = low;;) {
+        std::uint64_t segmentHigh = high - segmentLow < SEGMENT_SPAN ? high : segmentLow + SEGMENT_SPAN - 1;
+        std::uint64_t firstOdd = segmentLow | 1;
+        if (firstOdd <= segmentHigh) {
+            candidate.assign((segmentHigh - firstOdd) / 2 + 1, 1);
+            for (std::uint32_t prime : *basePrimes) {
+                std::uint64_t p = prime;
+                if (p == 2) {
+                    continue;
+                }
+                if (p * p > segmentHigh) {
+                    break;
+                }
+                std::uint64_t start = std::max(p * p, (segmentLow + p - 1) / p * p);
+                if (start % 2 == 0) {
+                    start += p;
+                }
+                for (std::uint64_t multiple = start; multiple <= segmentHigh; multiple += 2 * p) {
+                    candidate[(multiple - firstOdd) / 2] = 0;
+                    if (segmentHigh - multiple < 2 * p) {
+                        break;
+                    }
+                }
+            }
+            for (size_t i = 0; i < candidate.size(); ++i) {
+                if (candidate[i]) {
+                    visit(firstOdd + 2 * i);
+                }
+            }
+        }
+        if (segmentHigh == high) {
+            break;
+        }
+        segmentLow = segmentHigh + 1;
+    }
+}
+
+// Splits [low, high] into segment-aligned chunks, runs `work` on each in
+// the pool and returns the per-chunk results in range order. Called from
+// one of the pool's workers, the chunks run inline instead.
+template <typename Work>
+auto runChunked(std::uint64_t low, std::uint64_t high, ThreadPool& pool, Work work)
+    -> std::vector<decltype(work(low, high))> {
+    using Result = decltype(work(low, high));
+    std::uint64_t span = high - low;
+    std::uint64_t chunks = std::min<std::uint64_t>(pool.size() * 4, span / SEGMENT_SPAN + 1);
+    std::vector<Result> results;
+    if (chunks <= 1) {
+        results.push_back(work(low, high));
+        return results;
+    }
+
+    std::uint64_t chunkSpan = (span / chunks + SEGMENT_SPAN) / SEGMENT_SPAN * SEGMENT_SPAN;
+    const bool onWorker = pool.isWorkerThread();
+    std::vector<std::future<Result>> pending;
+    for (std::uint64_t chunkLow = low;;) {
+        std::uint64_t chunkHigh = high - chunkLow < chunkSpan ? high : chunkLow + chunkSpan - 1;
+        if (onWorker) {
+            results.push_back(work(chunkLow, chunkHigh));
+        } else {
+            pending.push_back(pool.submit([work, chunkLow, chunkHigh]() { return work(chunkLow, chunkHigh); }));
+        }
+        if (chunkHigh == high) {
+            break;
+        }
+        chunkLow = chunkHigh + 1;
+    }
+    for (auto& future : pending) {
+        results.push_back(future.get());
+    }
+    return results;
+}
+
+}
+
+PrimeSieve::PrimeSieve() : limit(1) {
+    composite.assign(1, 0);
+    extendTo(INITIAL_LIMIT);
+}
+
+bool PrimeSieve::lookup(std::uint64_t n) const {
+    if (n < 2) {
+        return false;
+    }
+    if (n % 2 == 0) {
+        return n == 2;
+    }
+    std::uint64_t bit = n / 2;
+    return !((composite[bit / 64] >> (bit % 64)) & 1);
+}
+
+// Sieves the odd numbers in [limit, newLimit) one cache-sized segment at
+// a time, using the primes already in the table as the base set. The
+// caller holds the exclusive lock.
+void PrimeSieve::extendTo(std::uint64_t newLimit) {
+    if (newLimit <= limit) {
+        return;
+    }
+    std::uint64_t oldLimit = limit;
+    composite.resize((newLimit / 2 + 64) / 64, 0);
+    auto mark = [this](std::uint64_t n) { composite[n / 128] |= std::uint64_t(1) << ((n / 2) % 64); };
+
+    if (oldLimit <= 1) {
+        mark(1);
+    }
+
+    for (std::uint64_t segmentLow = oldLimit; segmentLow < newLimit; segmentLow += SEGMENT_SPAN) {
+        std::uint64_t segmentHigh = std::min(newLimit, segmentLow + SEGMENT_SPAN);
+        for (std::uint64_t p = 3; p * p < segmentHigh; p += 2) {
+            if (!lookup(p)) {
+                continue;
+            }
+            std::uint64_t start = std::max(p * p, (segmentLow + p - 1) / p * p);
+            if (start % 2 == 0) {
+                start += p;
+            }
+            for (std::uint64_t multiple = start; multiple < segmentHigh; multiple += 2 * p) {
+                mark(multiple);
+            }
+        }
+    }
+    limit = newLimit;
+}
+
+bool PrimeSieve::isPrime(std::uint64_t n) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        if (n < limit) {
+            return lookup(n);
+        }
+    }
+    if (n < MAX_SIEVE_LIMIT) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        extendTo(std::min(MAX_SIEVE_LIMIT, std::max(limit * 2, n + 1)));
+        return lookup(n);
+    }
+    return millerRabin(n);
+}
+
+std::uint64_t PrimeSieve::sievedLimit() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return limit;
+}
+
+std::vector<std::uint32_t> PrimeSieve::primesUpTo(std::uint64_t bound) {
+    bound = std::min(bound, MAX_SIEVE_LIMIT - 1);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        extendTo(std::max(limit, bound + 1));
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<std::uint32_t> primes;
+    if (bound >= 2) {
+        primes.push_back(2);
+    }
+    for (std::uint64_t n = 3; n <= bound; n += 2) {
+        if (lookup(n)) {
+            primes.push_back(static_cast<std::uint32_t>(n));
+        }
+    }
+    return primes;
+}
+
+std::vector<std::uint32_t> PrimeSieve::basePrimesFor(std::uint64_t high, bool& available) {
+    std::uint64_t root = integerSqrt(high);
+    available = root < MAX_SIEVE_LIMIT;
+    return available ? primesUpTo(root) : std::vector<std::uint32_t>();
+}
+
+std::uint64_t PrimeSieve::countInRange(std::uint64_t low, std::uint64_t high, ThreadPool& pool) {
+    if (low > high) {
+        return 0;
+    }
+    bool sieve = false;
+    const std::vector<std::uint32_t> basePrimes = basePrimesFor(high, sieve);
+    const std::vector<std::uint32_t>* base = sieve ? &basePrimes : nullptr;
+
+    auto counts = runChunked(low, high, pool, [base](std::uint64_t chunkLow, std::uint64_t chunkHigh) {
+        std::uint64_t count = 0;
+        visitPrimes(chunkLow, chunkHigh, base, [&count](std::uint64_t) { ++count; });
+        return count;
+    });
+
+    std::uint64_t total = 0;
+    for (std::uint64_t count : counts) {
+        total += count;
+    }
+    return total;
+}
+
+std::vector<std::uint64_t> PrimeSieve::primesInRange(std::uint64_t low, std::uint64_t high, ThreadPool& pool) {
+    if (low > high) {
+        return {};
+    }
+    bool sieve = false;
+    const std::vector<std::uint32_t> basePrimes = basePrimesFor(high, sieve);
+    const std::vector<std::uint32_t>* base = sieve ? &basePrimes : nullptr;
+
+    auto parts = runChunked(low, high, pool, [base](std::uint64_t chunkLow, std::uint64_t chunkHigh) {
+        std::vector<std::uint64_t> primes;
+        visitPrimes(chunkLow, chunkHigh, base, [&primes](std::uint64_t p) { primes.push_back(p); });
+        return primes;
+    });
+
+    std::vector<std::uint64_t> primes;
+    for (const auto& part : parts) {
+        primes.insert(primes.end(), part.begin(), part.end());
+    }
+    return primes;
+}
+
+bool PrimeSieve::millerRabin(std::uint64_t n) {
+    return MathUtils::ct::millerRabin(n);
+}
+
+PrimeSieve& PrimeSieve::instance() {
+    static PrimeSieve sieve;
+    return sieve;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <shared_mutex>
+#include <vector>
+
+class ThreadPool;
+
+// Lazily grown odd-only sieve of Eratosthenes. Lookups below the sieved
+// limit are a single bit test; the table is extended segment by segment,
+// doubling its reach, whenever a query lands past the end, up to
+// MAX_SIEVE_LIMIT. Larger inputs use deterministic Miller-Rabin.
+class PrimeSieve {
+private:
+    std::vector<std::uint64_t> composite;
+    std::uint64_t limit;
+    mutable std::shared_mutex mutex;
+
+    bool lookup(std::uint64_t n) const;
+    void extendTo(std::uint64_t newLimit);
+    std::vector<std::uint32_t> basePrimesFor(std::uint64_t high, bool& available);
+
+public:
+    static constexpr std::uint64_t INITIAL_LIMIT = 1 << 16;
+    static constexpr std::uint64_t MAX_SIEVE_LIMIT = 1 << 24;
+
+    PrimeSieve();
+
+    PrimeSieve(const PrimeSieve&) = delete;
+    PrimeSieve& operator=(const PrimeSieve&) = delete;
+
+    bool isPrime(std::uint64_t n);
+    std::uint64_t sievedLimit() const;
+
+    // All primes <= bound; bound must not exceed MAX_SIEVE_LIMIT.
+    std::vector<std::uint32_t> primesUpTo(std::uint64_t bound);
+
+    // Inclusive ranges, split into segment-aligned chunks across the pool.
+    std::uint64_t countInRange(std::uint64_t low, std::uint64_t high, ThreadPool& pool);
+    std::vector<std::uint64_t> primesInRange(std::uint64_t low, std::uint64_t high, ThreadPool& pool);
+
+    static bool millerRabin(std::uint64_t n);
+
+    static PrimeSieve& instance();
+};
@@ -0,0 +1,207 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+// Read-only window over the contents of a RingBuffer. Wrapped storage is
+// exposed as two contiguous segments, oldest entries first; no element is
+// copied. A view is invalidated by any modification of its buffer.
+// Every entry carries the sequence number it was pushed with, so readers
+// can resume from endSequence() on their next poll.
+template <typename T>
+class RingBufferView {
+private:
+    const T* firstData;
+    size_t firstSize;
+    const T* secondData;
+    size_t secondSize;
+    uint64_t startSequence;
+
+public:
+    class const_iterator {
+    private:
+        const RingBufferView* view;
+        size_t index;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator(const RingBufferView* v, size_t i) : view(v), index(i) {}
+
+        reference operator*() const { return (*view)[index]; }
+        pointer operator->() const { return &(*view)[index]; }
+        const_iterator& operator++() { ++index; return *this; }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++index; return tmp; }
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+    };
+
+    RingBufferView()
+        : firstData(nullptr), firstSize(0), secondData(nullptr), secondSize(0), startSequence(0) {}
+
+    RingBufferView(const T* first, size_t firstCount, const T* second, size_t secondCount,
+                   uint64_t firstSequence = 0)
+        : firstData(first), firstSize(firstCount), secondData(second), secondSize(secondCount),
+          startSequence(firstSequence) {}
+
+    size_t size() const { return firstSize + secondSize; }
+    bool empty() const { return size() == 0; }
+
+    const T& operator[](size_t i) const {
+        return i < firstSize ? firstData[i] : secondData[i - firstSize];
+    }
+
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size() - 1]; }
+
+    uint64_t beginSequence() const { return startSequence; }
+    uint64_t endSequence() const { return startSequence + size(); }
+
+    const T* firstSegment() const { return firstData; }
+    size_t firstSegmentSize() const { return firstSize; }
+    const T* secondSegment() const { return secondData; }
+    size_t secondSegmentSize() const { return secondSize; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (size_t i = 0; i < firstSize; ++i) {
+            visit(firstData[i]);
+        }
+        for (size_t i = 0; i < secondSize; ++i) {
+            visit(secondData[i]);
+        }
+    }
+
+    std::vector<T> toVector() const {
+        std::vector<T> result;
+        result.reserve(size());
+        result.insert(result.end(), firstData, firstData + firstSize);
+        result.insert(result.end(), secondData, secondData + secondSize);
+        return result;
+    }
+};
+
+// Fixed-capacity FIFO that overwrites its oldest entry once full. Appends
+// are O(1) and never allocate after construction. Sequence numbers keep
+// increasing across clear() so incremental readers never see reused ids.
+template <typename T>
+class RingBuffer {
+private:
+    std::vector<T> storage;
+    size_t head;
+    size_t count;
+    uint64_t pushed;
+
+public:
+    explicit RingBuffer(size_t capacity) : head(0), count(0), pushed(0) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Ring buffer capacity must be positive");
+        }
+        storage.resize(capacity);
+    }
+
+    void push(const T& value) {
+        size_t tail = head + count;
+        if (tail >= storage.size()) {
+            tail -= storage.size();
+        }
+        storage[tail] = value;
+        ++pushed;
+        if (count < storage.size()) {
+            ++count;
+        } else if (++head == storage.size()) {
+            head = 0;
+        }
+    }
+
+    // Bulk append; only the newest capacity() values are copied, but every
+    // value still consumes a sequence number.
+    void pushRange(const T* values, size_t n) {
+        size_t cap = storage.size();
+        pushed += n;
+        if (n >= cap) {
+            std::copy(values + (n - cap), values + n, storage.begin());
+            head = 0;
+            count = cap;
+            return;
+        }
+
+        size_t tail = head + count;
+        if (tail >= cap) {
+            tail -= cap;
+        }
+        size_t firstCount = std::min(n, cap - tail);
+        std::copy(values, values + firstCount, storage.begin() + tail);
+        std::copy(values + firstCount, values + n, storage.begin());
+
+        count += n;
+        if (count > cap) {
+            head += count - cap;
+            if (head >= cap) {
+                head -= cap;
+            }
+            count = cap;
+        }
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return storage.size(); }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == storage.size(); }
+
+    uint64_t nextSequence() const { return pushed; }
+    uint64_t firstSequence() const { return pushed - count; }
+
+    const T& operator[](size_t i) const {
+        size_t index = head + i;
+        if (index >= storage.size()) {
+            index -= storage.size();
+        }
+        return storage[index];
+    }
+
+    const T& front() const { return storage[head]; }
+    const T& back() const { return (*this)[count - 1]; }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    RingBufferView<T> view() const {
+        return viewSince(firstSequence());
+    }
+
+    // Entries pushed at or after `sequence`; entries that were already
+    // overwritten or cleared are skipped.
+    RingBufferView<T> viewSince(uint64_t sequence) const {
+        uint64_t oldest = firstSequence();
+        size_t skip = 0;
+        if (sequence > oldest) {
+            skip = static_cast<size_t>(std::min<uint64_t>(sequence - oldest, count));
+        }
+
+        size_t start = head + skip;
+        if (start >= storage.size()) {
+            start -= storage.size();
+        }
+        size_t remaining = count - skip;
+        size_t firstCount = std::min(remaining, storage.size() - start);
+        return RingBufferView<T>(storage.data() + start, firstCount,
+                                 storage.data(), remaining - firstCount, oldest + skip);
+    }
+
+    std::vector<T> toVector() const {
+        return view().toVector();
+    }
+};
@@ -0,0 +1,127 @@
+#include "summation.hpp"
+#include <cmath>
+
+namespace {
+
+const size_t LANES = 4;
+const size_t PAIRWISE_BLOCK = 128;
+
+inline void neumaierStep(double& sum, double& compensation, double value) {
+    double t = sum + value;
+    if (std::fabs(sum) >= std::fabs(value)) {
+        compensation += (sum - t) + value;
+    } else {
+        compensation += (value - t) + sum;
+    }
+    sum = t;
+}
+
+inline void kahanStep(double& sum, double& compensation, double value) {
+    double y = value - compensation;
+    double t = sum + y;
+    compensation = (t - sum) - y;
+    sum = t;
+}
+
+}
+
+namespace Summation {
+
+double naive(const double* values, size_t count) {
+    double total = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+double kahan(const double* values, size_t count) {
+    double sums[LANES] = {};
+    double compensations[LANES] = {};
+
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            kahanStep(sums[lane], compensations[lane], values[i + lane]);
+        }
+    }
+
+    double total = 0.0;
+    double compensation = 0.0;
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        kahanStep(total, compensation, sums[lane]);
+        kahanStep(total, compensation, -compensations[lane]);
+    }
+    for (; i < count; ++i) {
+        kahanStep(total, compensation, values[i]);
+    }
+    return total;
+}
+
+double neumaier(const double* values, size_t count) {
+    double sums[LANES] = {};
+    double compensations[LANES] = {};
+
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            neumaierStep(sums[lane], compensations[lane], values[i + lane]);
+        }
+    }
+
+    double total = 0.0;
+    double compensation = 0.0;
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        neumaierStep(total, compensation, sums[lane]);
+        neumaierStep(total, compensation, compensations[lane]);
+    }
+    for (; i < count; ++i) {
+        neumaierStep(total, compensation, values[i]);
+    }
+    return total + compensation;
+}
+
+double pairwise(const double* values, size_t count) {
+    if (count <= PAIRWISE_BLOCK) {
+        double sums[LANES] = {};
+        size_t i = 0;
+        for (; i + LANES <= count; i += LANES) {
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                sums[lane] += values[i + lane];
+            }
+        }
+        double total = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        for (; i < count; ++i) {
+            total += values[i];
+        }
+        return total;
+    }
+
+    size_t half = (count / 2 + LANES - 1) / LANES * LANES;
+    return pairwise(values, half) + pairwise(values + half, count - half);
+}
+
+double sum(SummationMode mode, const double* values, size_t count) {
+    switch (mode) {
+        case SummationMode::Naive: return naive(values, count);
+        case SummationMode::Kahan: return kahan(values, count);
+        case SummationMode::Neumaier: return neumaier(values, count);
+        case SummationMode::Pairwise: return pairwise(values, count);
+    }
+    return neumaier(values, count);
+}
+
+void Accumulator::add(double value) {
+    neumaierStep(sum, compensation, value);
+}
+
+double Accumulator::total() const {
+    return sum + compensation;
+}
+
+void Accumulator::clear() {
+    sum = 0.0;
+    compensation = 0.0;
+}
+
+}
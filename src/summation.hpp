@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+
+enum class SummationMode {
+    Naive,
+    Kahan,
+    Neumaier,
+    Pairwise
+};
+
+// Floating-point summation kernels. Compensated sums run several
+// independent accumulator lanes so the loop vectorises, then fold the
+// lanes together with the same compensation. Neumaier also survives terms
+// larger than the running sum, which plain Kahan does not.
+namespace Summation {
+
+double naive(const double* values, size_t count);
+double kahan(const double* values, size_t count);
+double neumaier(const double* values, size_t count);
+double pairwise(const double* values, size_t count);
+
+double sum(SummationMode mode, const double* values, size_t count);
+
+// Running Neumaier sum for values that arrive one at a time.
+struct Accumulator {
+    double sum = 0.0;
+    double compensation = 0.0;
+
+    void add(double value);
+    double total() const;
+    void clear();
+};
+
+}
@@ -0,0 +1,69 @@
+#include "transform_cache.hpp"
+#include <cstring>
+
+TransformCache::TransformCache(size_t capacityBytes)
+    : capacityBytes(capacityBytes), usedBytes(0), hits(0), misses(0) {}
+
+size_t TransformCache::footprint(const Entry& entry) {
+    return entry.input.size() + entry.output->size();
+}
+
+std::shared_ptr<const std::string> TransformCache::find(std::uint64_t hash, const char* input, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = index.find(hash);
+    if (found == index.end() || found->second->input.size() != size ||
+        std::memcmp(found->second->input.data(), input, size) != 0) {
+        ++misses;
+        return nullptr;
+    }
+    ++hits;
+    recency.splice(recency.begin(), recency, found->second);
+    return found->second->output;
+}
+
+void TransformCache::insert(std::uint64_t hash, const char* input, size_t size,
+                            std::shared_ptr<const std::string> output) {
+    if (!output || size > capacityBytes || output->size() > capacityBytes - size) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = index.find(hash);
+    if (found != index.end()) {
+        usedBytes -= footprint(*found->second);
+        recency.erase(found->second);
+        index.erase(found);
+    }
+
+    const size_t needed = size + output->size();
+    while (!recency.empty() && usedBytes + needed > capacityBytes) {
+        usedBytes -= footprint(recency.back());
+        index.erase(recency.back().hash);
+        recency.pop_back();
+    }
+
+    usedBytes += needed;
+    recency.push_front(Entry{hash, std::string(input, size), std::move(output)});
+    index[hash] = recency.begin();
+}
+
+void TransformCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    recency.clear();
+    index.clear();
+    usedBytes = 0;
+}
+
+size_t TransformCache::capacity() const {
+    return capacityBytes;
+}
+
+TransformCacheStats TransformCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    TransformCacheStats result;
+    result.hits = hits;
+    result.misses = misses;
+    result.entries = index.size();
+    result.bytes = usedBytes;
+    return result;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+struct TransformCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+};
+
+// Content-addressed LRU of transformed outputs, bounded by the total size
+// of the stored inputs and outputs. Entries are found by the 64-bit hash
+// of the input, and a hit also compares the stored input byte for byte, so
+// colliding inputs never share an output. Thread-safe.
+class TransformCache {
+private:
+    struct Entry {
+        std::uint64_t hash;
+        std::string input;
+        std::shared_ptr<const std::string> output;
+    };
+
+    size_t capacityBytes;
+    size_t usedBytes;
+    size_t hits;
+    size_t misses;
+    std::list<Entry> recency;
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index;
+    mutable std::mutex mutex;
+
+    static size_t footprint(const Entry& entry);
+
+public:
+    explicit TransformCache(size_t capacityBytes);
+
+    // Returns the output cached for exactly these input bytes and marks it
+    // most recently used, or nullptr.
+    std::shared_ptr<const std::string> find(std::uint64_t hash, const char* input, size_t size);
+    // Replaces any entry with the same hash. Entries larger than the whole
+    // capacity are not stored.
+    void insert(std::uint64_t hash, const char* input, size_t size, std::shared_ptr<const std::string> output);
+    void clear();
+
+    size_t capacity() const;
+    TransformCacheStats stats() const;
+};
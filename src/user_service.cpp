@@ -7,12 +7,12 @@ UserService::UserService(std::unique_ptr<IDatabase> db, std::unique_ptr<ILogger>
 
 bool UserService::createUser(const User& user) {
     if (user.id.empty() || user.name.empty() || user.email.empty()) {
-        logger->error("Invalid user data: missing required fields");
+        logger->log(LogLevel::Error, "Invalid user data: missing required fields");
         return false;
     }
     
     if (database->exists(user.id)) {
-        logger->warning("User already exists: " + user.id);
+        logger->log(LogLevel::Warning, "User already exists: ", user.id);
         return false;
     }
     
@@ -20,9 +20,9 @@ bool UserService::createUser(const User& user) {
     bool success = database->save(user.id, userData);
     
     if (success) {
-        logger->info("User created successfully: " + user.id);
+        logger->log(LogLevel::Info, "User created successfully: ", user.id);
     } else {
-        logger->error("Failed to create user: " + user.id);
+        logger->log(LogLevel::Error, "Failed to create user: ", user.id);
     }
     
     return success;
@@ -30,39 +30,39 @@ bool UserService::createUser(const User& user) {
 
 User* UserService::getUser(const std::string& userId) {
     if (userId.empty()) {
-        logger->error("Invalid user ID: empty string");
+        logger->log(LogLevel::Error, "Invalid user ID: empty string");
         return nullptr;
     }
     
     if (!database->exists(userId)) {
-        logger->warning("User not found: " + userId);
+        logger->log(LogLevel::Warning, "User not found: ", userId);
         return nullptr;
     }
     
     std::string userData = database->load(userId);
     if (userData.empty()) {
-        logger->error("Failed to load user data: " + userId);
+        logger->log(LogLevel::Error, "Failed to load user data: ", userId);
         return nullptr;
     }
     
     try {
         User user = stringToUser(userData);
-        logger->info("User retrieved successfully: " + userId);
+        logger->log(LogLevel::Info, "User retrieved successfully: ", userId);
         return new User(user);
     } catch (const std::exception& e) {
-        logger->error("Failed to parse user data: " + userId);
+        logger->log(LogLevel::Error, "Failed to parse user data: ", userId);
         return nullptr;
     }
 }
 
 bool UserService::updateUser(const User& user) {
     if (user.id.empty()) {
-        logger->error("Cannot update user: empty ID");
+        logger->log(LogLevel::Error, "Cannot update user: empty ID");
         return false;
     }
     
     if (!database->exists(user.id)) {
-        logger->warning("Cannot update non-existent user: " + user.id);
+        logger->log(LogLevel::Warning, "Cannot update non-existent user: ", user.id);
         return false;
     }
     
@@ -70,9 +70,9 @@ bool UserService::updateUser(const User& user) {
     bool success = database->save(user.id, userData);
     
     if (success) {
-        logger->info("User updated successfully: " + user.id);
+        logger->log(LogLevel::Info, "User updated successfully: ", user.id);
     } else {
-        logger->error("Failed to update user: " + user.id);
+        logger->log(LogLevel::Error, "Failed to update user: ", user.id);
     }
     
     return success;
@@ -80,28 +80,28 @@ bool UserService::updateUser(const User& user) {
 
 bool UserService::deleteUser(const std::string& userId) {
     if (userId.empty()) {
-        logger->error("Cannot delete user: empty ID");
+        logger->log(LogLevel::Error, "Cannot delete user: empty ID");
         return false;
     }
     
     if (!database->exists(userId)) {
-        logger->warning("Cannot delete non-existent user: " + userId);
+        logger->log(LogLevel::Warning, "Cannot delete non-existent user: ", userId);
         return false;
     }
     
     bool success = database->remove(userId);
     
     if (success) {
-        logger->info("User deleted successfully: " + userId);
+        logger->log(LogLevel::Info, "User deleted successfully: ", userId);
     } else {
-        logger->error("Failed to delete user: " + userId);
+        logger->log(LogLevel::Error, "Failed to delete user: ", userId);
     }
     
     return success;
 }
 
 std::vector<std::string> UserService::getAllUserIds() {
-    logger->debug("Retrieving all user IDs");
+    logger->log(LogLevel::Debug, "Retrieving all user IDs");
     return database->getAllKeys();
 }
 
@@ -1,6 +1,12 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 #include "../src/math_utils.hpp"
+#include "../src/int_reductions.hpp"
+#include "../src/math_constexpr.hpp"
+#include "../src/thread_pool.hpp"
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 TEST_CASE("Basic arithmetic operations") {
     CHECK(MathUtils::add(2, 3) == 5);
@@ -33,6 +39,27 @@ TEST_CASE("Testing factorial function") {
     REQUIRE(MathUtils::factorial(1) == 1);
     CHECK(MathUtils::factorial(3) == 6);
     CHECK(MathUtils::factorial(5) == 120);
+    CHECK(MathUtils::factorial(12) == 479001600);
+}
+
+TEST_CASE("Factorial beyond the int range") {
+    CHECK(MathUtils::factorial64(13) == 6227020800ULL);
+    CHECK(MathUtils::factorial64(20) == 2432902008176640000ULL);
+
+    REQUIRE(MathUtils::checkedFactorial(20).has_value());
+    CHECK(*MathUtils::checkedFactorial(20) == 2432902008176640000ULL);
+    CHECK_FALSE(MathUtils::checkedFactorial(21).has_value());
+
+    CHECK(MathUtils::bigFactorial(0) == "1");
+    CHECK(MathUtils::bigFactorial(20) == "2432902008176640000");
+    CHECK(MathUtils::bigFactorial(25) == "15511210043330985984000000");
+    CHECK(MathUtils::bigFactorial(100) ==
+          "93326215443944152681699238856266700490715968264381621468592963895217599993229915608941463976156518286253697920827223758251185210916864000000000000000000000000");
+
+    std::string thousand = MathUtils::bigFactorial(1000);
+    CHECK(thousand.size() == 2568);
+    CHECK(thousand.compare(0, 12, "402387260077") == 0);
+    CHECK(thousand.find_last_not_of('0') == thousand.size() - 250);
 }
 
 TEST_CASE("Prime number testing") {
@@ -43,4 +70,161 @@ TEST_CASE("Prime number testing") {
     CHECK(MathUtils::isPrime(5));
     CHECK_FALSE(MathUtils::isPrime(9));
     CHECK(MathUtils::isPrime(17));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Prime testing beyond the initial sieve") {
+    int mismatches = 0;
+    for (int n = 0; n < 100000; ++n) {
+        bool trial = n >= 2;
+        for (int d = 2; d * d <= n && trial; ++d) {
+            trial = n % d != 0;
+        }
+        mismatches += MathUtils::isPrime(n) != trial;
+    }
+    CHECK(mismatches == 0);
+
+    CHECK_FALSE(MathUtils::isPrime(-7));
+    CHECK(MathUtils::isPrime(2147483647));
+    CHECK(MathUtils::isPrime64(18446744073709551557ULL));
+    CHECK_FALSE(MathUtils::isPrime64(3215031751ULL));
+    CHECK_FALSE(MathUtils::isPrime64(18446744073709551615ULL));
+}
+
+TEST_CASE("Counting and listing primes in a range") {
+    CHECK(MathUtils::countPrimes(0, 100) == 25);
+    CHECK(MathUtils::countPrimes(1, 1000000) == 78498);
+    CHECK(MathUtils::countPrimes(20, 10) == 0);
+    CHECK(MathUtils::primesInRange(90, 110) == std::vector<std::uint64_t>{97, 101, 103, 107, 109});
+
+    SUBCASE("Sieved and Miller-Rabin paths agree") {
+        const std::uint64_t low = 1000000000000ULL;
+        const std::uint64_t high = low + 20000;
+        std::uint64_t expected = 0;
+        for (std::uint64_t n = low; n <= high; ++n) {
+            expected += MathUtils::isPrime64(n);
+        }
+        CHECK(MathUtils::countPrimes(low, high) == expected);
+        CHECK(MathUtils::primesInRange(low, high).size() == expected);
+    }
+}
+
+TEST_CASE("Vectorised integer reductions") {
+    std::vector<int> numbers;
+    for (int i = 0; i < 1003; ++i) {
+        numbers.push_back((i * 7919) % 2001 - 1000);
+    }
+    numbers[517] = std::numeric_limits<int>::max();
+    numbers[1001] = std::numeric_limits<int>::min();
+
+    std::int64_t expectedSum = 0;
+    for (int n : numbers) {
+        expectedSum += n;
+    }
+
+    CHECK(MathUtils::findMax(numbers) == std::numeric_limits<int>::max());
+    CHECK(MathUtils::findMin(numbers) == std::numeric_limits<int>::min());
+    CHECK(MathUtils::sum(numbers) == expectedSum);
+    CHECK(MathUtils::findMax(numbers.data(), 3) == std::max({numbers[0], numbers[1], numbers[2]}));
+
+    SUBCASE("Sums do not overflow int") {
+        std::vector<int> large(10000, 2000000000);
+        CHECK(MathUtils::sum(large) == 20000000000000LL);
+        CHECK(MathUtils::average(large) == doctest::Approx(2e9));
+    }
+
+    SUBCASE("Every instruction set matches the scalar kernel") {
+        auto scalar = IntReductions::summarizeShifted(IntReductions::Isa::Scalar, numbers.data(), numbers.size(), 5);
+        for (auto isa : {IntReductions::Isa::Sse41, IntReductions::Isa::Avx2}) {
+            auto summary = IntReductions::summarizeShifted(isa, numbers.data(), numbers.size(), 5);
+            CHECK(summary.min == scalar.min);
+            CHECK(summary.max == scalar.max);
+            CHECK(summary.sum == scalar.sum);
+            CHECK(summary.shiftedSquares == doctest::Approx(scalar.shiftedSquares));
+        }
+    }
+}
+
+TEST_CASE("Single-pass statistics") {
+    MathUtils::Stats stats = MathUtils::computeStats({2, 4, 4, 4, 5, 5, 7, 9});
+    CHECK(stats.min == 2);
+    CHECK(stats.max == 9);
+    CHECK(stats.sum == 40);
+    CHECK(stats.mean == doctest::Approx(5.0));
+    CHECK(stats.variance == doctest::Approx(4.0));
+    CHECK(stats.count == 8);
+
+    std::vector<int> offset(1000);
+    for (size_t i = 0; i < offset.size(); ++i) {
+        offset[i] = 1000000000 + static_cast<int>(i % 2);
+    }
+    CHECK(MathUtils::computeStats(offset).variance == doctest::Approx(0.25));
+
+    CHECK_THROWS_AS(MathUtils::computeStats(std::vector<int>{}), std::invalid_argument);
+}
+
+TEST_CASE("Parallel reductions match the sequential ones") {
+    std::vector<int> numbers(IntReductions::PARALLEL_THRESHOLD * 3 + 37);
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        numbers[i] = static_cast<int>((i * 2654435761u) % 4000001) - 2000000;
+    }
+    numbers[numbers.size() - 1] = 2000000001;
+
+    ThreadPool single(1);
+    ThreadPool wide(4);
+
+    CHECK(MathUtils::findMax(numbers, wide) == MathUtils::findMax(numbers));
+    CHECK(MathUtils::findMin(numbers, wide) == MathUtils::findMin(numbers));
+    CHECK(MathUtils::sum(numbers, wide) == MathUtils::sum(numbers));
+    CHECK(MathUtils::average(numbers, wide) == doctest::Approx(MathUtils::average(numbers)));
+
+    MathUtils::Stats fromWide = MathUtils::computeStats(numbers, wide);
+    MathUtils::Stats fromSingle = MathUtils::computeStats(numbers, single);
+    CHECK(fromWide.variance == fromSingle.variance);
+    CHECK(fromWide.variance == doctest::Approx(MathUtils::computeStats(numbers).variance));
+
+    std::vector<int> small = {3, -1, 4};
+    CHECK(MathUtils::findMin(small, wide) == -1);
+    CHECK_THROWS_AS(MathUtils::findMax(std::vector<int>{}, wide), std::invalid_argument);
+}
+
+TEST_CASE("Parallel work submitted from a pool's own worker runs inline") {
+    std::vector<int> numbers(IntReductions::PARALLEL_THRESHOLD * 2 + 5);
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        numbers[i] = static_cast<int>(i % 1000) - 500;
+    }
+
+    ThreadPool single(1);
+    CHECK_FALSE(single.isWorkerThread());
+    auto nested = single.submit([&numbers, &single]() {
+        CHECK(single.isWorkerThread());
+        return MathUtils::computeStats(numbers, single);
+    });
+    CHECK(nested.get().variance == MathUtils::computeStats(numbers, single).variance);
+
+    auto primes = ThreadPool::shared().submit([]() { return MathUtils::countPrimes(1, 1000000); });
+    CHECK(primes.get() == 78498);
+}
+
+TEST_CASE("Compile-time MathUtils functions") {
+    static_assert(MathUtils::ct::add(2, 3) == 5, "add");
+    static_assert(MathUtils::ct::multiply(-4, 6) == -24, "multiply");
+    static_assert(MathUtils::ct::factorial(10) == 3628800, "10!");
+    static_assert(MathUtils::ct::factorial<int>(12) == 479001600, "12! fits int");
+    static_assert(MathUtils::ct::power(2, 20) == 1048576, "2^20");
+    static_assert(MathUtils::ct::isPrime(97) && !MathUtils::ct::isPrime(91), "small primes");
+    static_assert(MathUtils::ct::isPrime(2147483647), "Mersenne prime");
+    static_assert(!MathUtils::ct::isPrime(3215031751LL), "strong pseudoprime to bases 2, 3, 5, 7");
+
+    constexpr std::array<bool, 4> flags = {MathUtils::ct::isPrime(0), MathUtils::ct::isPrime(1),
+                                           MathUtils::ct::isPrime(2), MathUtils::ct::isPrime(3)};
+    CHECK(flags == std::array<bool, 4>{false, false, true, true});
+
+    int mismatches = 0;
+    for (int n = -3; n < 5000; ++n) {
+        mismatches += MathUtils::ct::isPrime(n) != MathUtils::isPrime(n);
+    }
+    CHECK(mismatches == 0);
+    CHECK(MathUtils::ct::factorial(20) == MathUtils::factorial64(20));
+    CHECK_THROWS_AS(MathUtils::ct::factorial<int>(13), std::overflow_error);
+    CHECK_THROWS_AS(MathUtils::ct::factorial(-1), std::invalid_argument);
+}
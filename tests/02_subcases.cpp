@@ -1,6 +1,8 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 #include "../src/math_utils.hpp"
+#include "../src/math_constexpr.hpp"
+#include <limits>
 
 TEST_CASE("Power function with different bases and exponents") {
     SUBCASE("Base 2") {
@@ -33,6 +35,28 @@ TEST_CASE("Power function with different bases and exponents") {
         CHECK(MathUtils::power(1, 100) == 1);
         CHECK(MathUtils::power(-2, 2) == 4);
         CHECK(MathUtils::power(-2, 3) == -8);
+        CHECK(MathUtils::power(-1, 1000001) == -1);
+    }
+
+    SUBCASE("Results at the edge of the range") {
+        CHECK(MathUtils::power(2, 30) == 1073741824);
+        CHECK(MathUtils::power(-2, 31) == std::numeric_limits<int>::min());
+        CHECK(MathUtils::power64(3, 39) == 4052555153018976267LL);
+        CHECK(MathUtils::power64(-2, 63) == std::numeric_limits<std::int64_t>::min());
+    }
+
+    SUBCASE("Modular power") {
+        CHECK(MathUtils::powmod(2, 10, 1000) == 24);
+        CHECK(MathUtils::powmod(7, 0, 1) == 0);
+        CHECK(MathUtils::powmod(4, 13, 497) == 445);
+        CHECK(MathUtils::powmod(2, 18446744073709551556ULL, 18446744073709551557ULL) == 1);
+    }
+
+    SUBCASE("Compile-time evaluation") {
+        static_assert(MathUtils::ct::power(3, 4) == 81, "3^4");
+        static_assert(MathUtils::ct::power<std::int64_t>(10, 18) == 1000000000000000000LL, "10^18");
+        static_assert(MathUtils::ct::powmod(3, 200, 1000000007) == 136318165ULL, "3^200 mod p");
+        CHECK(MathUtils::ct::power(2, 10) == MathUtils::power(2, 10));
     }
 }
 
@@ -96,4 +120,22 @@ TEST_CASE("Number to words conversion") {
         CHECK(MathUtils::numberToWords(67) == "sixty seven");
         CHECK(MathUtils::numberToWords(99) == "ninety nine");
     }
+
+    SUBCASE("Hundreds and larger scales") {
+        CHECK(MathUtils::numberToWords(100) == "one hundred");
+        CHECK(MathUtils::numberToWords(123) == "one hundred twenty three");
+        CHECK(MathUtils::numberToWords(1000000) == "one million");
+        CHECK(MathUtils::numberToWords(2000017) == "two million seventeen");
+        CHECK(MathUtils::numberToWords(-45) == "minus forty five");
+        CHECK(MathUtils::numberToWords(std::numeric_limits<std::int64_t>::min()) ==
+              "minus nine quintillion two hundred twenty three quadrillion three hundred seventy two trillion "
+              "thirty six billion eight hundred fifty four million seven hundred seventy five thousand eight hundred eight");
+    }
+
+    SUBCASE("Appending to an existing string") {
+        std::string report = "total:";
+        report += ' ';
+        MathUtils::numberToWords(512, report);
+        CHECK(report == "total: five hundred twelve");
+    }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 #include "../src/math_utils.hpp"
+#include <limits>
 
 TEST_CASE("Exception testing with CHECK_THROWS") {
     CHECK_THROWS(MathUtils::divide(5.0, 0.0));
@@ -32,6 +33,28 @@ TEST_CASE("Exception testing with message verification") {
     CHECK_THROWS_WITH(MathUtils::average(empty_vec), "Cannot calculate average of empty vector");
 }
 
+TEST_CASE("Factorial overflow is reported") {
+    CHECK_THROWS_AS(MathUtils::factorial(13), std::overflow_error);
+    CHECK_THROWS_WITH(MathUtils::factorial(13), "Factorial result overflows int");
+    CHECK_THROWS_AS(MathUtils::factorial64(21), std::overflow_error);
+    CHECK_THROWS_WITH(MathUtils::factorial64(21), "Factorial result overflows 64-bit integer");
+
+    CHECK_THROWS_AS(MathUtils::checkedFactorial(-1), std::invalid_argument);
+    CHECK_THROWS_AS(MathUtils::bigFactorial(-1), std::invalid_argument);
+    CHECK_NOTHROW(MathUtils::checkedFactorial(100));
+}
+
+TEST_CASE("Power overflow and invalid modulus are reported") {
+    CHECK_THROWS_AS(MathUtils::power(2, 31), std::overflow_error);
+    CHECK_THROWS_WITH(MathUtils::power(2, 31), "Power result overflows int");
+    CHECK_THROWS_AS(MathUtils::power(46341, 2), std::overflow_error);
+    CHECK_THROWS_WITH(MathUtils::power64(3, 40), "Power result overflows 64-bit integer");
+    CHECK_THROWS_WITH(MathUtils::power64(2, -1), "Negative exponent not supported");
+
+    CHECK_THROWS_AS(MathUtils::powmod(2, 10, 0), std::invalid_argument);
+    CHECK_THROWS_WITH(MathUtils::powmod(2, 10, 0), "Modulus must be positive");
+}
+
 TEST_CASE("Testing functions that should NOT throw") {
     CHECK_NOTHROW(MathUtils::add(5, 3));
     CHECK_NOTHROW(MathUtils::multiply(-2, 4));
@@ -46,10 +69,10 @@ TEST_CASE("Testing functions that should NOT throw") {
 }
 
 TEST_CASE("Edge cases for numberToWords function") {
-    CHECK_THROWS_AS(MathUtils::numberToWords(-1), std::invalid_argument);
-    CHECK_THROWS_AS(MathUtils::numberToWords(100), std::invalid_argument);
-    CHECK_THROWS_WITH(MathUtils::numberToWords(-5), "Only numbers 0-99 supported");
-    CHECK_THROWS_WITH(MathUtils::numberToWords(150), "Only numbers 0-99 supported");
+    CHECK_NOTHROW(MathUtils::numberToWords(-1));
+    CHECK_NOTHROW(MathUtils::numberToWords(100));
+    CHECK_NOTHROW(MathUtils::numberToWords(std::numeric_limits<std::int64_t>::min()));
+    CHECK_NOTHROW(MathUtils::numberToWords(std::numeric_limits<std::int64_t>::max()));
     
     CHECK_NOTHROW(MathUtils::numberToWords(0));
     CHECK_NOTHROW(MathUtils::numberToWords(50));
@@ -1,6 +1,11 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 #include "../src/calculator.hpp"
+#include "../src/concurrent_calculator.hpp"
+#include <cmath>
+#include <limits>
+#include <set>
+#include <thread>
 
 TEST_CASE("Calculator basic arithmetic operations") {
     Calculator calc;
@@ -11,6 +16,88 @@ TEST_CASE("Calculator basic arithmetic operations") {
     CHECK(calc.divide(15.0, 3.0) == doctest::Approx(5.0));
 }
 
+TEST_CASE("Calculator batch arithmetic") {
+    Calculator calc;
+    std::vector<double> a = {1.0, 2.0, 3.0, 4.0};
+    std::vector<double> b = {4.0, 0.0, 2.0, 0.5};
+
+    SUBCASE("Element-wise operations") {
+        auto sums = calc.addBatch(a, b);
+        auto differences = calc.subtractBatch(a, b);
+        auto products = calc.multiplyBatch(a, b);
+
+        CHECK(sums[1] == doctest::Approx(2.0));
+        CHECK(differences[0] == doctest::Approx(-3.0));
+        CHECK(products[3] == doctest::Approx(2.0));
+    }
+
+    SUBCASE("Division by zero is reported per element") {
+        std::vector<unsigned char> divisionByZero;
+        auto quotients = calc.divideBatch(a, b, &divisionByZero);
+
+        REQUIRE(quotients.size() == 4);
+        CHECK(quotients[0] == doctest::Approx(0.25));
+        CHECK(std::isnan(quotients[1]));
+        CHECK(quotients[3] == doctest::Approx(8.0));
+        CHECK(divisionByZero == std::vector<unsigned char>{0, 1, 0, 0});
+
+        std::vector<double> out(4);
+        CHECK(calc.divideBatch(a.data(), b.data(), out.data(), out.size()) == 1);
+    }
+
+    SUBCASE("History is appended once per batch") {
+        uint64_t cursor = calc.getHistorySequence();
+        calc.multiplyBatch(a, a);
+
+        auto fresh = calc.getHistorySince(cursor);
+        REQUIRE(fresh.size() == 4);
+        CHECK(fresh[2] == doctest::Approx(9.0));
+        CHECK(calc.getLastResult() == doctest::Approx(16.0));
+    }
+
+    CHECK_THROWS_WITH(calc.addBatch(a, std::vector<double>(2)), "Batch operands must have the same size");
+}
+
+TEST_CASE("Calculator compensated summation") {
+    Calculator calc;
+    REQUIRE(calc.getSummationMode() == SummationMode::Neumaier);
+
+    std::vector<double> tenths(1000000, 0.1);
+
+    SUBCASE("Batch sum in every mode") {
+        calc.setSummationMode(SummationMode::Naive);
+        double naive = calc.sum(tenths);
+        CHECK(std::fabs(naive - 100000.0) > 1e-7);
+
+        for (SummationMode mode : {SummationMode::Kahan, SummationMode::Neumaier, SummationMode::Pairwise}) {
+            calc.setSummationMode(mode);
+            CHECK(std::fabs(calc.sum(tenths) - 100000.0) < 1e-9);
+        }
+        CHECK(calc.getLastResult() == doctest::Approx(100000.0));
+    }
+
+    SUBCASE("Neumaier handles terms larger than the running sum") {
+        std::vector<double> values = {1.0, 1e100, 1.0, -1e100};
+        CHECK(calc.sum(values) == 2.0);
+
+        calc.setSummationMode(SummationMode::Kahan);
+        CHECK(calc.sum(values) == 0.0);
+    }
+
+    SUBCASE("Chained accumulation does not drift") {
+        for (size_t i = 0; i < tenths.size(); ++i) {
+            calc.accumulate(tenths[i]);
+        }
+        CHECK(std::fabs(calc.getAccumulator() - 100000.0) < 1e-9);
+        CHECK(calc.getLastResult() == calc.getAccumulator());
+
+        calc.clearAccumulator();
+        CHECK(calc.getAccumulator() == 0.0);
+    }
+
+    CHECK(calc.sum(std::vector<double>()) == 0.0);
+}
+
 TEST_CASE("Calculator memory operations") {
     Calculator calc;
     
@@ -44,6 +131,101 @@ TEST_CASE("Calculator history tracking") {
     CHECK(calc.getHistory().empty());
 }
 
+TEST_CASE("Calculator history ring buffer") {
+    SUBCASE("Default capacity keeps the last 100 results") {
+        Calculator calc;
+        REQUIRE(calc.getHistoryCapacity() == 100);
+
+        for (int i = 0; i < 250; ++i) {
+            calc.add(i, 0.0);
+        }
+
+        auto history = calc.getHistory();
+        REQUIRE(history.size() == 100);
+        CHECK(history.front() == doctest::Approx(150.0));
+        CHECK(history.back() == doctest::Approx(249.0));
+    }
+
+    SUBCASE("Custom capacity") {
+        Calculator calc(3);
+        REQUIRE(calc.getHistoryCapacity() == 3);
+
+        calc.add(1.0, 0.0);
+        calc.add(2.0, 0.0);
+        calc.add(3.0, 0.0);
+        calc.add(4.0, 0.0);
+
+        auto history = calc.getHistory();
+        REQUIRE(history.size() == 3);
+        CHECK(history[0] == doctest::Approx(2.0));
+        CHECK(history[2] == doctest::Approx(4.0));
+        CHECK(calc.getLastResult() == doctest::Approx(4.0));
+    }
+
+    SUBCASE("View matches the copied history without copying") {
+        Calculator calc(4);
+        for (int i = 1; i <= 6; ++i) {
+            calc.multiply(i, 2.0);
+        }
+
+        auto view = calc.getHistoryView();
+        auto history = calc.getHistory();
+        REQUIRE(view.size() == history.size());
+        CHECK(view.firstSegmentSize() + view.secondSegmentSize() == 4);
+
+        size_t index = 0;
+        for (double value : view) {
+            CHECK(value == doctest::Approx(history[index++]));
+        }
+        CHECK(view.back() == doctest::Approx(12.0));
+    }
+
+    CHECK_THROWS_AS(Calculator(0), std::invalid_argument);
+}
+
+TEST_CASE("Calculator incremental history reads") {
+    Calculator calc(5);
+    REQUIRE(calc.getHistorySequence() == 0);
+
+    calc.add(1.0, 1.0);
+    calc.add(2.0, 2.0);
+    uint64_t cursor = calc.getHistorySequence();
+    REQUIRE(cursor == 2);
+
+    SUBCASE("Only entries after the cursor are returned") {
+        calc.add(3.0, 3.0);
+        auto fresh = calc.getHistorySince(cursor);
+        REQUIRE(fresh.size() == 1);
+        CHECK(fresh.beginSequence() == 2);
+        CHECK(fresh[0] == doctest::Approx(6.0));
+        CHECK(fresh.endSequence() == calc.getHistorySequence());
+
+        CHECK(calc.getHistorySince(fresh.endSequence()).empty());
+    }
+
+    SUBCASE("Overwritten entries are skipped") {
+        for (int i = 0; i < 7; ++i) {
+            calc.add(i, 10.0);
+        }
+        auto fresh = calc.getHistorySince(cursor);
+        REQUIRE(fresh.size() == 5);
+        CHECK(fresh.beginSequence() == 4);
+
+        double total = 0.0;
+        fresh.forEach([&total](double value) { total += value; });
+        CHECK(total == doctest::Approx(10.0 * 5 + 2 + 3 + 4 + 5 + 6));
+    }
+
+    SUBCASE("Sequence numbers survive clearing") {
+        calc.clearHistory();
+        CHECK(calc.getHistorySequence() == cursor);
+        calc.add(4.0, 4.0);
+        auto fresh = calc.getHistorySince(0);
+        REQUIRE(fresh.size() == 1);
+        CHECK(fresh.beginSequence() == cursor);
+    }
+}
+
 TEST_CASE("Calculator trigonometric functions") {
     Calculator calc;
     
@@ -68,6 +250,108 @@ TEST_CASE("Calculator trigonometric functions") {
     }
 }
 
+TEST_CASE("Calculator fused and batch trigonometry") {
+    Calculator calc;
+
+    SUBCASE("sincos returns both results") {
+        auto result = calc.sincos(30.0);
+        CHECK(result.first == doctest::Approx(0.5));
+        CHECK(result.second == doctest::Approx(std::sqrt(3.0) / 2.0));
+        CHECK(calc.getLastResult() == doctest::Approx(result.second));
+    }
+
+    SUBCASE("Fused calls record every sine, then every cosine") {
+        calc.sincos(90.0);
+        CHECK(calc.getHistory() == std::vector<double>{1.0, std::cos(90.0 * M_PI / 180.0)});
+
+        calc.clearHistory();
+        calc.sincosBatch({0.0, 90.0, 180.0});
+        auto history = calc.getHistory();
+        REQUIRE(history.size() == 6);
+        CHECK(history[0] == 0.0);
+        CHECK(history[1] == 1.0);
+        CHECK(history[3] == 1.0);
+        CHECK(history[5] == -1.0);
+        CHECK(calc.getLastResult() == -1.0);
+    }
+
+    SUBCASE("Batch results match scalar results") {
+        std::vector<double> angles = {-720.0, -45.0, 0.0, 30.0, 90.0, 135.0, 1000.5};
+        auto sines = calc.sinBatch(angles);
+        auto cosines = calc.cosBatch(angles);
+        auto both = calc.sincosBatch(angles);
+
+        for (size_t i = 0; i < angles.size(); ++i) {
+            CHECK(sines[i] == doctest::Approx(calc.sin(angles[i])));
+            CHECK(cosines[i] == doctest::Approx(calc.cos(angles[i])));
+            CHECK(both.first[i] == doctest::Approx(sines[i]));
+            CHECK(both.second[i] == doctest::Approx(cosines[i]));
+        }
+    }
+
+    SUBCASE("Fast mode stays within the documented error") {
+        Calculator exact;
+        calc.setFastTrigMode(true);
+        REQUIRE(calc.isFastTrigMode());
+
+        for (bool degrees : {true, false}) {
+            calc.setDegreesMode(degrees);
+            exact.setDegreesMode(degrees);
+
+            std::vector<double> angles;
+            for (double angle = -5000.0; angle <= 5000.0; angle += 0.37) {
+                angles.push_back(angle);
+            }
+            auto fast = calc.sincosBatch(angles);
+            for (size_t i = 0; i < angles.size(); ++i) {
+                auto reference = exact.sincos(angles[i]);
+                REQUIRE(std::fabs(fast.first[i] - reference.first) <= FastTrig::MAX_ERROR);
+                REQUIRE(std::fabs(fast.second[i] - reference.second) <= FastTrig::MAX_ERROR);
+            }
+        }
+
+        calc.setDegreesMode(true);
+        CHECK(calc.sin(180.0) == 0.0);
+        CHECK(calc.cos(-90.0) == 0.0);
+        CHECK(calc.sin(270.0) == -1.0);
+
+        calc.reset();
+        CHECK_FALSE(calc.isFastTrigMode());
+    }
+
+    SUBCASE("Fast mode handles huge and non-finite angles") {
+        calc.setFastTrigMode(true);
+        const double inf = std::numeric_limits<double>::infinity();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const double hugeAngles[] = {1e7 + 0.5, -3.7e12, 1e300, -1e300};
+
+        for (bool degrees : {true, false}) {
+            calc.setDegreesMode(degrees);
+            auto results = calc.sincosBatch({nan, inf, -inf});
+            for (size_t i = 0; i < 3; ++i) {
+                CHECK(std::isnan(results.first[i]));
+                CHECK(std::isnan(results.second[i]));
+            }
+        }
+
+        calc.setDegreesMode(true);
+        for (double angle : hugeAngles) {
+            const double radians = std::fmod(angle, 360.0) * (M_PI / 180.0);
+            auto fast = calc.sincos(angle);
+            CHECK(std::fabs(fast.first - std::sin(radians)) <= FastTrig::MAX_ERROR);
+            CHECK(std::fabs(fast.second - std::cos(radians)) <= FastTrig::MAX_ERROR);
+        }
+        CHECK(calc.cos(360.0 * 1e15) == 1.0);
+
+        calc.setDegreesMode(false);
+        for (double angle : hugeAngles) {
+            auto fast = calc.sincos(angle);
+            CHECK(fast.first == std::sin(angle));
+            CHECK(fast.second == std::cos(angle));
+        }
+    }
+}
+
 TEST_CASE("Calculator power and square root") {
     Calculator calc;
     
@@ -109,6 +393,139 @@ TEST_CASE("Calculator expression evaluation") {
     CHECK_THROWS_WITH(calc.evaluateExpression(""), "Empty expression");
 }
 
+TEST_CASE("Calculator expression parser") {
+    Calculator calc;
+
+    SUBCASE("Precedence and parentheses") {
+        CHECK(calc.evaluateExpression("2 + 3 * 4") == doctest::Approx(14.0));
+        CHECK(calc.evaluateExpression("(2 + 3) * 4") == doctest::Approx(20.0));
+        CHECK(calc.evaluateExpression("2 ^ 3 ^ 2") == doctest::Approx(512.0));
+        CHECK(calc.evaluateExpression("-2 ^ 2") == doctest::Approx(-4.0));
+        CHECK(calc.evaluateExpression("10 / 4 - -1.5") == doctest::Approx(4.0));
+        CHECK(calc.evaluateExpression("1.5e2 + .5") == doctest::Approx(150.5));
+    }
+
+    SUBCASE("Functions, memory and variables") {
+        calc.setMemory(9.0);
+        calc.setVariable("x", 3.0);
+        calc.setVariable("rate_2", 0.5);
+
+        CHECK(calc.evaluateExpression("sqrt(memory) + x") == doctest::Approx(6.0));
+        CHECK(calc.evaluateExpression("power(x, 2) * rate_2") == doctest::Approx(4.5));
+        CHECK(calc.evaluateExpression("sin(90) + cos(0)") == doctest::Approx(2.0));
+
+        calc.setDegreesMode(false);
+        CHECK(calc.evaluateExpression("sin(pi / 2)") == doctest::Approx(1.0));
+
+        calc.setVariable("x", 4.0);
+        CHECK(calc.evaluateExpression("power(x, 2) * rate_2") == doctest::Approx(8.0));
+        CHECK(calc.getLastResult() == doctest::Approx(8.0));
+    }
+
+    SUBCASE("Compiled expressions are cached and reusable") {
+        calc.setVariable("x", 1.0);
+        auto compiled = calc.compileExpression("x * x + 1");
+        CHECK(calc.compileExpression("x * x + 1") == compiled);
+        CHECK(calc.getCachedExpressionCount() == 1);
+        REQUIRE(compiled->getVariables().size() == 1);
+
+        double x = 3.0;
+        CHECK(compiled->evaluate({&x, 0.0, true}) == doctest::Approx(10.0));
+        CHECK(calc.evaluateCompiled(*compiled) == doctest::Approx(2.0));
+
+        calc.evaluateExpression("x * x + 1");
+        CHECK(calc.getCachedExpressionCount() == 1);
+    }
+
+    SUBCASE("The expression cache evicts the least recently used entry") {
+        auto first = calc.compileExpression("0 + 1");
+        std::shared_ptr<const CompiledExpression> oldest;
+        for (size_t i = 1; i < Calculator::MAX_CACHED_EXPRESSIONS; ++i) {
+            auto compiled = calc.compileExpression(std::to_string(i) + " + 1");
+            if (i == 2) {
+                oldest = compiled;
+            }
+        }
+        CHECK(calc.getCachedExpressionCount() == Calculator::MAX_CACHED_EXPRESSIONS);
+
+        CHECK(calc.compileExpression("0 + 1") == first);
+        auto second = calc.compileExpression("1 + 1");
+        calc.compileExpression("x + 1");
+        CHECK(calc.getCachedExpressionCount() == Calculator::MAX_CACHED_EXPRESSIONS);
+        CHECK(calc.compileExpression("0 + 1") == first);
+        CHECK(calc.compileExpression("1 + 1") == second);
+        CHECK(calc.getCachedExpressionCount() == Calculator::MAX_CACHED_EXPRESSIONS);
+        CHECK(calc.compileExpression("2 + 1") != oldest);
+
+        calc.clearExpressionCache();
+        CHECK(calc.getCachedExpressionCount() == 0);
+        CHECK(calc.evaluateExpression("0 + 1") == doctest::Approx(1.0));
+    }
+
+    SUBCASE("Constant subexpressions are folded") {
+        auto compiled = calc.compileExpression("(1 + 2) * 3 - sqrt(16)");
+        CHECK(compiled->getInstructions().size() == 1);
+        CHECK(calc.evaluateCompiled(*compiled) == doctest::Approx(5.0));
+    }
+
+    SUBCASE("Errors") {
+        CHECK_THROWS_WITH(calc.evaluateExpression("(1 + 2"), "Mismatched parentheses");
+        CHECK_THROWS_WITH(calc.evaluateExpression("1 + 2)"), "Mismatched parentheses");
+        CHECK_THROWS_WITH(calc.evaluateExpression("1 $ 2"), "Unexpected character in expression: $");
+        CHECK_THROWS_WITH(calc.evaluateExpression("foo(1)"), "Unknown function: foo");
+        CHECK_THROWS_WITH(calc.evaluateExpression("power(1)"), "Wrong number of arguments for function: power");
+        CHECK_THROWS_WITH(calc.evaluateExpression("y + 1"), "Unknown variable: y");
+        CHECK_THROWS_WITH(calc.evaluateExpression("1 / 0"), "Division by zero");
+        CHECK_THROWS_WITH(calc.evaluateExpression("sqrt(-4)"), "Cannot take square root of negative number");
+        CHECK_THROWS_AS(calc.setVariable("sin", 1.0), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Calculator batch expression evaluation") {
+    Calculator calc;
+    calc.setMemory(10.0);
+    calc.setVariable("scale", 2.0);
+
+    const size_t rows = 1000;
+    std::vector<double> x(rows), y(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        x[i] = static_cast<double>(i);
+        y[i] = static_cast<double>(rows - i);
+    }
+
+    SUBCASE("Columns match row-by-row evaluation") {
+        auto results = calc.evaluateExpressionBatch("(x + y) * scale - memory / 2 + sqrt(x)",
+                                                    {{"x", x}, {"y", y}});
+        REQUIRE(results.size() == rows);
+
+        for (size_t i = 0; i < rows; i += 97) {
+            calc.setVariable("x", x[i]);
+            calc.setVariable("y", y[i]);
+            CHECK(results[i] == doctest::Approx(calc.evaluateExpression("(x + y) * scale - memory / 2 + sqrt(x)")));
+        }
+    }
+
+    SUBCASE("Raw column pointers and history") {
+        std::vector<double> out(rows);
+        uint64_t cursor = calc.getHistorySequence();
+        calc.evaluateExpressionBatch("sin(x)", {{"x", x.data()}}, rows, out.data());
+
+        CHECK(out[90] == doctest::Approx(1.0));
+        CHECK(calc.getHistorySequence() == cursor + rows);
+        CHECK(calc.getLastResult() == doctest::Approx(out.back()));
+    }
+
+    SUBCASE("Invalid rows do not abort the batch") {
+        auto results = calc.evaluateExpressionBatch("1 / x", {{"x", x}});
+        CHECK(std::isinf(results[0]));
+        CHECK(results[4] == doctest::Approx(0.25));
+    }
+
+    CHECK_THROWS_WITH(calc.evaluateExpressionBatch("x + z", {{"x", x}}), "Unknown variable: z");
+    CHECK_THROWS_WITH(calc.evaluateExpressionBatch("x + y", {{"x", x}, {"y", std::vector<double>(3)}}),
+                      "Batch columns must have the same size");
+}
+
 SCENARIO("Using calculator for a complex calculation") {
     GIVEN("A new calculator") {
         Calculator calc;
@@ -151,4 +568,46 @@ SCENARIO("Using calculator for a complex calculation") {
             }
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Concurrent calculator shared between threads") {
+    ConcurrentCalculator calc(64);
+    const int threadCount = 4;
+    const int operationsPerThread = 5000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&calc, t, operationsPerThread]() {
+            for (int i = 0; i < operationsPerThread; ++i) {
+                calc.add(t * operationsPerThread, i);
+                if (i % 1000 == 0) {
+                    calc.setMemory(i);
+                    calc.getHistory();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    CHECK(calc.getHistorySequence() == static_cast<uint64_t>(threadCount * operationsPerThread));
+
+    auto history = calc.getHistory();
+    REQUIRE(history.size() == 64);
+    std::set<double> unique(history.begin(), history.end());
+    CHECK(unique.size() == history.size());
+    for (double value : history) {
+        CHECK(value >= 0.0);
+        CHECK(value < threadCount * operationsPerThread);
+    }
+    CHECK(calc.getMemory() == doctest::Approx(4000.0));
+
+    calc.clearHistory();
+    CHECK(calc.getHistory().empty());
+    CHECK_THROWS_AS(calc.getLastResult(), std::runtime_error);
+
+    calc.multiply(6.0, 7.0);
+    CHECK(calc.getLastResult() == doctest::Approx(42.0));
+    CHECK_THROWS_WITH(calc.divide(1.0, 0.0), "Division by zero");
+}
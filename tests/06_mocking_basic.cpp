@@ -2,6 +2,10 @@
 #include "../doctest.h"
 #include "../fakeit.hpp"
 #include "../src/interfaces.hpp"
+#include "../src/user_service.hpp"
+#include <string>
+#include <utility>
+#include <vector>
 
 using namespace fakeit;
 
@@ -161,4 +165,37 @@ TEST_CASE("Sequential return values") {
     Verify(Method(mockDb, exists).Using("test")).Exactly(3_Times);
     Verify(Method(mockDb, save).Using("test", "data")).Once();  // Only saved once
     Verify(Method(mockLogger, warning).Using(_)).Exactly(2_Times);  // Two "already exists" warnings
-}
\ No newline at end of file
+}
+
+TEST_CASE("Mocked logger with the real UserService") {
+    Mock<IDatabase> mockDb;
+    Mock<ILogger> mockLogger;
+    
+    // UserService owns its dependencies, so let it "delete" the mocks
+    Fake(Dtor(mockDb));
+    Fake(Dtor(mockLogger));
+    When(Method(mockDb, exists)).AlwaysReturn(false);
+    
+    // UserService logs through log(), which asks isEnabled() and hands the
+    // message to write(). FakeIt keeps arguments by reference, so copy the
+    // messages to check them after the calls return.
+    std::vector<std::pair<LogLevel, std::string>> logged;
+    When(Method(mockLogger, isEnabled)).AlwaysReturn(true);
+    When(Method(mockLogger, write)).AlwaysDo([&logged](LogLevel level, const std::string& message) {
+        logged.emplace_back(level, message);
+    });
+    
+    {
+        UserService service(std::unique_ptr<IDatabase>(&mockDb.get()), std::unique_ptr<ILogger>(&mockLogger.get()));
+        CHECK(service.getUser("alice") == nullptr);
+        CHECK(service.getUser("bob") == nullptr);
+    }
+    
+    REQUIRE(logged.size() == 2);
+    CHECK(logged[0].first == LogLevel::Warning);
+    CHECK(logged[0].second == "User not found: alice");
+    CHECK(logged[1].first == LogLevel::Warning);
+    CHECK(logged[1].second == "User not found: bob");
+    Verify(Method(mockLogger, write)).Exactly(2_Times);
+    VerifyNoOtherInvocations(Method(mockLogger, info), Method(mockLogger, warning));
+}
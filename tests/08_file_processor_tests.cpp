@@ -0,0 +1,827 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../doctest.h"
+#include "../src/async_file_logger.hpp"
+#include "../src/async_file_system.hpp"
+#include "../src/content_hash.hpp"
+#include "../src/file_processor.hpp"
+#include "../src/posix_file_system.hpp"
+#include "../src/spsc_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <sstream>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+// In-memory file system that records how it is used. Chunked access can
+// be switched off to exercise the IFileSystem defaults. A single mutex
+// makes it safe for the parallel tests.
+class InMemoryFileSystem : public IFileSystem {
+public:
+    std::map<std::string, std::string> files;
+    std::recursive_mutex mutex;
+    bool chunked = true;
+    int wholeFileReads = 0;
+    size_t largestChunk = 0;
+    int inPlaceWrites = 0;
+
+    bool supportsChunkedIo() const override { return chunked; }
+
+    bool writeFile(const std::string& filename, const std::string& content) override {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        files[filename] = content;
+        return true;
+    }
+
+    std::string readFile(const std::string& filename) override {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        ++wholeFileReads;
+        return files.at(filename);
+    }
+
+    bool deleteFile(const std::string& filename) override {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        return files.erase(filename) > 0;
+    }
+
+    bool fileExists(const std::string& filename) override {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        return files.count(filename) > 0;
+    }
+
+    size_t getFileSize(const std::string& filename) override {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        return fileExists(filename) ? files[filename].size() : 0;
+    }
+
+    size_t readChunk(const std::string& filename, size_t offset, char* buffer, size_t size) override {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        if (!chunked) {
+            return IFileSystem::readChunk(filename, offset, buffer, size);
+        }
+        const std::string& content = files.at(filename);
+        size_t count = offset < content.size() ? std::min(size, content.size() - offset) : 0;
+        content.copy(buffer, count, offset);
+        largestChunk = std::max(largestChunk, count);
+        return count;
+    }
+
+    bool appendChunk(const std::string& filename, const char* data, size_t size) override {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        if (!chunked) {
+            return IFileSystem::appendChunk(filename, data, size);
+        }
+        files[filename].append(data, size);
+        return true;
+    }
+
+    bool writeChunkAt(const std::string& filename, size_t offset, const char* data, size_t size) override {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        auto file = files.find(filename);
+        if (file == files.end() || offset + size > file->second.size()) {
+            return false;
+        }
+        file->second.replace(offset, size, data, size);
+        ++inPlaceWrites;
+        return true;
+    }
+};
+
+class SilentLogger : public ILogger {
+public:
+    std::atomic<int> errors{0};
+
+    void info(const std::string&) override {}
+    void warning(const std::string&) override {}
+    void error(const std::string&) override { ++errors; }
+    void debug(const std::string&) override {}
+};
+
+// Records the messages that reach it and discards levels below threshold.
+class ThresholdLogger : public ILogger {
+public:
+    LogLevel threshold = LogLevel::Warning;
+    std::vector<std::string> messages;
+
+    void info(const std::string& message) override { messages.push_back("info: " + message); }
+    void warning(const std::string& message) override { messages.push_back("warning: " + message); }
+    void error(const std::string& message) override { messages.push_back("error: " + message); }
+    void debug(const std::string& message) override { messages.push_back("debug: " + message); }
+
+    bool isEnabled(LogLevel level) const override { return level >= threshold; }
+};
+
+// Holds every append until opened, so a logger's ring fills up behind it.
+class GatedFileSystem : public InMemoryFileSystem {
+public:
+    std::atomic<bool> open{false};
+
+    bool appendChunk(const std::string& filename, const char* data, size_t size) override {
+        while (!open) {
+            std::this_thread::yield();
+        }
+        return InMemoryFileSystem::appendChunk(filename, data, size);
+    }
+};
+
+std::vector<std::string> splitLines(const std::string& text) {
+    std::vector<std::string> lines;
+    std::istringstream stream(text);
+    for (std::string line; std::getline(stream, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+// Fails reads and throws from reads or writes of chosen files.
+class FaultyFileSystem : public InMemoryFileSystem {
+public:
+    std::string unreadable;
+    std::string throwOnRead;
+    std::string throwOnAppend;
+    std::string unwritable;
+
+    size_t readChunk(const std::string& filename, size_t offset, char* buffer, size_t size) override {
+        if (filename == throwOnRead) {
+            throw std::runtime_error("read failed");
+        }
+        if (filename == unreadable) {
+            return 0;
+        }
+        return InMemoryFileSystem::readChunk(filename, offset, buffer, size);
+    }
+
+    bool appendChunk(const std::string& filename, const char* data, size_t size) override {
+        if (filename == throwOnAppend) {
+            throw std::runtime_error("write failed");
+        }
+        if (filename == unwritable) {
+            return false;
+        }
+        return InMemoryFileSystem::appendChunk(filename, data, size);
+    }
+};
+
+struct ProcessorFixture {
+    InMemoryFileSystem* fs = new InMemoryFileSystem();
+    SilentLogger* logger = new SilentLogger();
+    FileProcessor processor{std::unique_ptr<IFileSystem>(fs), nullptr, std::unique_ptr<ILogger>(logger)};
+};
+
+TEST_CASE_FIXTURE(ProcessorFixture, "Small files are processed in memory") {
+    fs->files["input.txt"] = "hello, World";
+
+    CHECK(processor.processFile("input.txt", "output.txt"));
+    CHECK(fs->files["output.txt"] == "PROCESSED: HELLO, WORLD");
+    CHECK(fs->wholeFileReads == 1);
+    CHECK(processor.getTotalProcessedSize() == 12);
+}
+
+TEST_CASE_FIXTURE(ProcessorFixture, "Large files are streamed in bounded chunks") {
+    std::string content(3 * FileProcessor::MAX_IN_MEMORY_SIZE + 17, 'x');
+    content[5] = 'a';
+    fs->files["big.txt"] = content;
+
+    CHECK(processor.processFile("big.txt", "big.out"));
+
+    const std::string& output = fs->files["big.out"];
+    REQUIRE(output.size() == 11 + content.size());
+    CHECK(output.compare(0, 17, "PROCESSED: XXXXXA") == 0);
+    CHECK(output.find('x') == std::string::npos);
+    CHECK(fs->wholeFileReads == 0);
+    CHECK(fs->largestChunk == FileProcessor::DEFAULT_CHUNK_SIZE);
+    CHECK(processor.getTotalProcessedSize() == content.size());
+}
+
+TEST_CASE_FIXTURE(ProcessorFixture, "Streaming works through the default IFileSystem hooks") {
+    fs->chunked = false;
+    fs->files["input.txt"] = "streaming through defaults";
+
+    CHECK(processor.processFileStreaming("input.txt", "output.txt", 4));
+    CHECK(fs->files["output.txt"] == "PROCESSED: STREAMING THROUGH DEFAULTS");
+
+    // Without real chunked I/O a large file takes the in-memory path.
+    int reads = fs->wholeFileReads;
+    fs->files["big.txt"] = std::string(FileProcessor::MAX_IN_MEMORY_SIZE + 1, 'b');
+    CHECK_FALSE(processor.processFile("big.txt", "big.out"));
+    CHECK(fs->wholeFileReads == reads + 1);
+    CHECK(fs->largestChunk == 0);
+}
+
+TEST_CASE_FIXTURE(ProcessorFixture, "Streaming a file onto itself keeps the input intact") {
+    fs->files["input.txt"] = "in place";
+
+    CHECK(processor.processFileStreaming("input.txt", "input.txt", 3));
+    CHECK(fs->files["input.txt"] == "PROCESSED: IN PLACE");
+    CHECK(fs->files.count("input.txt.tmp") == 0);
+}
+
+TEST_CASE_FIXTURE(ProcessorFixture, "Streaming rejects bad input") {
+    fs->files["empty.txt"] = "";
+
+    CHECK_FALSE(processor.processFileStreaming("missing.txt", "out.txt"));
+    CHECK_FALSE(processor.processFileStreaming("empty.txt", "out.txt"));
+    CHECK_FALSE(processor.processFileStreaming("empty.txt", "out.txt", 0));
+    CHECK(fs->files.count("out.txt") == 0);
+    CHECK(processor.getTotalProcessedSize() == 0);
+}
+
+TEST_CASE("ASCII case kernels agree across instruction sets") {
+    std::string input;
+    for (int round = 0; round < 3; ++round) {
+        for (int c = 0; c < 256; ++c) {
+            input.push_back(static_cast<char>(c));
+        }
+    }
+
+    std::string expectedUpper = input;
+    std::string expectedLower = input;
+    for (size_t i = 0; i < input.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(input[i]);
+        if (c >= 'a' && c <= 'z') expectedUpper[i] = static_cast<char>(c - 32);
+        if (c >= 'A' && c <= 'Z') expectedLower[i] = static_cast<char>(c + 32);
+    }
+
+    for (auto isa : {ByteTransform::Isa::Portable, ByteTransform::Isa::Sse2, ByteTransform::Isa::Avx2}) {
+        CAPTURE(static_cast<int>(isa));
+        // Odd offsets and lengths cover unaligned heads and every tail size.
+        for (size_t offset : {0, 1, 7}) {
+            size_t length = input.size() - offset - 5;
+            std::string output(length, '\0');
+            ByteTransform::toUpperAscii(isa, input.data() + offset, &output[0], length);
+            CHECK(output == expectedUpper.substr(offset, length));
+            ByteTransform::toLowerAscii(isa, input.data() + offset, &output[0], length);
+            CHECK(output == expectedLower.substr(offset, length));
+        }
+
+        std::string inPlace = input;
+        ByteTransform::toUpperAscii(isa, inPlace.data(), &inPlace[0], inPlace.size());
+        CHECK(inPlace == expectedUpper);
+    }
+}
+
+TEST_CASE_FIXTURE(ProcessorFixture, "The content transform is pluggable") {
+    fs->files["input.txt"] = "Mixed Case";
+    ByteTransform::Kernel upper = ByteTransform::toUpperAscii;
+    CHECK(processor.getTransform() == upper);
+
+    processor.setTransform(ByteTransform::toLowerAscii);
+    CHECK(processor.processFile("input.txt", "lower.txt"));
+    CHECK(fs->files["lower.txt"] == "PROCESSED: mixed case");
+
+    processor.setTransform([](const char* input, char* output, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            output[i] = input[i] == ' ' ? '_' : input[i];
+        }
+    });
+    CHECK(processor.processFileStreaming("input.txt", "custom.txt", 3));
+    CHECK(fs->files["custom.txt"] == "PROCESSED: Mixed_Case");
+
+    processor.setTransform(nullptr);
+    CHECK(processor.processFile("input.txt", "copy.txt"));
+    CHECK(fs->files["copy.txt"] == "PROCESSED: Mixed Case");
+}
+
+TEST_CASE_FIXTURE(ProcessorFixture, "Repeated content is served from the transform cache") {
+    fs->files["a.txt"] = "same text";
+    fs->files["b.txt"] = "same text";
+    fs->files["c.txt"] = "other text";
+    processor.enableTransformCache(1024);
+
+    CHECK(processor.processFile("a.txt", "a.out"));
+    CHECK(processor.processFile("b.txt", "b.out"));
+    CHECK(processor.processFile("c.txt", "c.out"));
+    CHECK(fs->files["b.out"] == "PROCESSED: SAME TEXT");
+    CHECK(fs->files["c.out"] == "PROCESSED: OTHER TEXT");
+    CHECK(processor.getTotalProcessedSize() == 28);
+
+    TransformCacheStats stats = processor.getTransformCacheStats();
+    CHECK(stats.hits == 1);
+    CHECK(stats.misses == 2);
+    CHECK(stats.entries == 2);
+    CHECK(stats.bytes == 9 + 20 + 10 + 21);
+
+    processor.setTransform(ByteTransform::toLowerAscii);
+    CHECK(processor.getTransformCacheStats().entries == 0);
+    CHECK(processor.processFile("a.txt", "a.out"));
+    CHECK(fs->files["a.out"] == "PROCESSED: same text");
+
+    processor.enableTransformCache(0);
+    CHECK(processor.processFile("a.txt", "a.out"));
+    CHECK(processor.getTransformCacheStats().misses == 0);
+}
+
+TEST_CASE("Transform cache evicts least recently used outputs") {
+    auto output = [](char c) { return std::make_shared<const std::string>(30, c); };
+    const std::string input(10, 'i');
+    TransformCache cache(100);
+    CHECK(cache.capacity() == 100);
+
+    cache.insert(1, input.data(), input.size(), output('a'));
+    cache.insert(2, input.data(), input.size(), output('b'));
+    CHECK(cache.find(1, input.data(), input.size()) != nullptr);
+    CHECK(cache.find(1, input.data(), input.size() - 1) == nullptr);
+    cache.insert(3, input.data(), input.size(), output('c'));
+
+    CHECK(cache.find(2, input.data(), input.size()) == nullptr);
+    CHECK(*cache.find(1, input.data(), input.size()) == std::string(30, 'a'));
+    CHECK(*cache.find(3, input.data(), input.size()) == std::string(30, 'c'));
+    CHECK(cache.stats().bytes == 80);
+
+    cache.insert(4, input.data(), input.size(), std::make_shared<const std::string>(91, 'd'));
+    CHECK(cache.find(4, input.data(), input.size()) == nullptr);
+    CHECK(cache.stats().entries == 2);
+
+    cache.clear();
+    CHECK(cache.stats().entries == 0);
+    CHECK(cache.stats().bytes == 0);
+}
+
+TEST_CASE("Transform cache never returns another input's output on a hash collision") {
+    const std::string first = "first input";
+    const std::string second = "other input";
+    TransformCache cache(1024);
+
+    cache.insert(7, first.data(), first.size(), std::make_shared<const std::string>("FIRST"));
+    CHECK(cache.find(7, second.data(), second.size()) == nullptr);
+    CHECK(*cache.find(7, first.data(), first.size()) == "FIRST");
+
+    cache.insert(7, second.data(), second.size(), std::make_shared<const std::string>("OTHER"));
+    CHECK(cache.stats().entries == 1);
+    CHECK(cache.find(7, first.data(), first.size()) == nullptr);
+    CHECK(*cache.find(7, second.data(), second.size()) == "OTHER");
+}
+
+TEST_CASE("xxh64 matches the reference implementation") {
+    CHECK(ContentHash::xxh64("", 0) == 0xEF46DB3751D8E999ULL);
+    CHECK(ContentHash::xxh64("a", 1) == 0xD24EC4F1A98C6E5BULL);
+    CHECK(ContentHash::xxh64("abc", 3) == 0x44BC2CF5AD770999ULL);
+    std::string longInput(100, 'x');
+    CHECK(ContentHash::xxh64(longInput.data(), longInput.size()) == 0x92F0DE5A88A3C094ULL);
+}
+
+TEST_CASE_FIXTURE(ProcessorFixture, "Backups only rewrite the chunks that changed") {
+    std::string content(3 * FileProcessor::BACKUP_CHUNK_SIZE + 10, 'b');
+    fs->files["data.bin"] = content;
+
+    CHECK(processor.backupFile("data.bin"));
+    CHECK(fs->files["data.bin.backup"] == content);
+    CHECK(processor.backupFile("data.bin"));
+    CHECK(processor.getBackupStats().fullCopies == 1);
+    CHECK(processor.getBackupStats().skipped == 1);
+
+    fs->files["data.bin"][FileProcessor::BACKUP_CHUNK_SIZE + 5] = 'X';
+    fs->files["data.bin"].back() = 'Y';
+    CHECK(processor.backupFile("data.bin"));
+    CHECK(fs->files["data.bin.backup"] == fs->files["data.bin"]);
+    CHECK(fs->inPlaceWrites == 2);
+    CHECK(processor.getBackupStats().incrementalUpdates == 1);
+    CHECK(processor.getBackupStats().chunksRewritten == 2);
+
+    fs->files["data.bin"] += "grown";
+    CHECK(processor.backupFile("data.bin"));
+    fs->files["data.bin.backup"] = "tampered";
+    CHECK(processor.backupFile("data.bin"));
+    CHECK(fs->files["data.bin.backup"] == fs->files["data.bin"]);
+    CHECK(processor.getBackupStats().fullCopies == 3);
+
+    CHECK_FALSE(processor.backupFile("missing.bin"));
+    CHECK(logger->errors == 1);
+}
+
+TEST_CASE("Log messages are only built for enabled levels") {
+    ThresholdLogger logger;
+    int formatted = 0;
+    auto format = [&formatted]() {
+        ++formatted;
+        return std::string("lazy");
+    };
+
+    logger.log(LogLevel::Info, "dropped ", 1);
+    logger.logLazy(LogLevel::Debug, format);
+    CHECK(logger.messages.empty());
+    CHECK(formatted == 0);
+
+    logger.log(LogLevel::Error, "count ", 42, ' ', -7, ' ', true, ' ', 2.5, ' ', std::string("text"));
+    logger.threshold = LogLevel::Debug;
+    logger.logLazy(LogLevel::Debug, format);
+    logger.write(LogLevel::Warning, "direct");
+    CHECK(formatted == 1);
+    CHECK(logger.messages == std::vector<std::string>{"error: count 42 -7 true 2.5 text", "debug: lazy", "warning: direct"});
+
+    InMemoryFileSystem* fs = new InMemoryFileSystem();
+    ThresholdLogger* processorLogger = new ThresholdLogger();
+    FileProcessor processor(std::unique_ptr<IFileSystem>(fs), nullptr, std::unique_ptr<ILogger>(processorLogger));
+    fs->files["input.txt"] = "quiet";
+    CHECK(processor.processFile("input.txt", "output.txt"));
+    CHECK_FALSE(processor.processFile("missing.txt", "output.txt"));
+    CHECK(processorLogger->messages == std::vector<std::string>{"error: Input file does not exist: missing.txt"});
+}
+
+TEST_CASE("Async logger drops or samples records when its ring is full") {
+    GatedFileSystem* fs = new GatedFileSystem();
+    AsyncFileLogger logger(std::unique_ptr<IFileSystem>(fs), "app.log", 8, OverflowPolicy::Drop);
+    CHECK(logger.capacity() == 8);
+
+    for (int i = 0; i < 100; ++i) {
+        logger.log(LogLevel::Info, "message ", i);
+    }
+    AsyncLoggerStats stats = logger.stats();
+    CHECK(stats.written == 0);
+    CHECK(stats.dropped >= 84);
+
+    fs->open = true;
+    logger.flush();
+    stats = logger.stats();
+    CHECK(stats.written + stats.dropped == 100);
+    std::vector<std::string> lines = splitLines(fs->files["app.log"]);
+    CHECK(lines.size() == stats.written);
+    CHECK(lines.front() == "[INFO] message 0");
+
+    GatedFileSystem* sampledFs = new GatedFileSystem();
+    AsyncFileLogger sampled(std::unique_ptr<IFileSystem>(sampledFs), "sampled.log", 2, OverflowPolicy::Sample, 4);
+    std::thread opener([&sampled, sampledFs]() {
+        while (sampled.stats().dropped < 3) {
+            std::this_thread::yield();
+        }
+        sampledFs->open = true;
+    });
+    size_t submitted = 0;
+    while (sampled.stats().dropped < 3) {
+        sampled.submit(LogLevel::Warning, "burst");
+        ++submitted;
+    }
+    CHECK(sampled.submit(LogLevel::Warning, "kept"));
+    opener.join();
+    sampled.flush();
+    CHECK(sampled.stats().dropped == 3);
+    CHECK(sampled.stats().written == submitted - 2);
+    CHECK(splitLines(sampledFs->files["sampled.log"]).back() == "[WARNING] kept");
+
+    CHECK_THROWS_AS(AsyncFileLogger(std::make_unique<InMemoryFileSystem>(), "x.log", 0), std::invalid_argument);
+    auto unchunked = std::make_unique<InMemoryFileSystem>();
+    unchunked->chunked = false;
+    CHECK_THROWS_AS(AsyncFileLogger(std::move(unchunked), "x.log"), std::invalid_argument);
+}
+
+TEST_CASE("Async logger counts batches it cannot write as dropped") {
+    FaultyFileSystem* fs = new FaultyFileSystem();
+    fs->throwOnAppend = "broken.log";
+    AsyncFileLogger logger(std::unique_ptr<IFileSystem>(fs), "broken.log", 16, OverflowPolicy::Block);
+
+    for (int i = 0; i < 100; ++i) {
+        logger.info("lost");
+    }
+    logger.flush();
+    CHECK(logger.stats().written == 0);
+    CHECK(logger.stats().dropped == 100);
+}
+
+TEST_CASE_FIXTURE(ProcessorFixture, "Multiple files are processed in parallel in input order") {
+    std::vector<std::string> names;
+    size_t expectedSize = 0;
+    for (int i = 0; i < 2000; ++i) {
+        std::string name = "file" + std::to_string(i) + ".txt";
+        names.push_back(name);
+        if (i % 7 != 3) {
+            fs->files[name] = "content " + std::to_string(i);
+            expectedSize += fs->files[name].size();
+        }
+    }
+
+    processor.setWorkerCount(4);
+    CHECK(processor.getWorkerCount() == 4);
+    std::vector<std::string> results = processor.processMultipleFiles(names);
+
+    std::vector<std::string> expected;
+    for (int i = 0; i < 2000; ++i) {
+        if (i % 7 != 3) {
+            expected.push_back(names[i] + ".processed");
+        }
+    }
+    CHECK(results == expected);
+    CHECK(fs->files["file12.txt.processed"] == "PROCESSED: CONTENT 12");
+    CHECK(processor.getTotalProcessedSize() == expectedSize);
+    CHECK(logger->errors == 2000 - static_cast<int>(expected.size()));
+
+    processor.setWorkerCount(0);
+    CHECK(processor.getWorkerCount() == 1);
+}
+
+TEST_CASE("SPSC queue hands items across threads in order") {
+    SpscQueue<int> queue(5);
+    CHECK(queue.capacity() == 8);
+
+    const int count = 100000;
+    std::thread producer([&queue]() {
+        for (int i = 0; i < count; ++i) {
+            while (!queue.tryPush(i)) {
+                std::this_thread::yield();
+            }
+        }
+        queue.close();
+    });
+
+    int expected = 0;
+    bool ordered = true;
+    for (int value = 0; !queue.isDrained();) {
+        if (queue.tryPop(value)) {
+            ordered = ordered && value == expected;
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    CHECK(ordered);
+    CHECK(expected == count);
+    CHECK_THROWS_AS(SpscQueue<int>(0), std::invalid_argument);
+}
+
+TEST_CASE_FIXTURE(ProcessorFixture, "Pipelined processing overlaps the stages") {
+    std::vector<std::string> names;
+    size_t expectedBytes = 0;
+    for (int i = 0; i < 40; ++i) {
+        std::string name = "part" + std::to_string(i);
+        names.push_back(name);
+        if (i != 13) {
+            fs->files[name] = std::string(1 + i * 997, static_cast<char>('a' + i % 26));
+            expectedBytes += fs->files[name].size();
+        }
+    }
+
+    std::vector<std::string> results = processor.processFilesPipelined(names, 512, 2);
+
+    CHECK(results.size() == 39);
+    CHECK(results.front() == "part0.processed");
+    CHECK(std::find(results.begin(), results.end(), "part13.processed") == results.end());
+    CHECK(fs->files["part25.processed"] == "PROCESSED: " + std::string(1 + 25 * 997, 'Z'));
+    CHECK(processor.getTotalProcessedSize() == expectedBytes);
+    CHECK(logger->errors == 1);
+
+    PipelineStats stats = processor.getPipelineStats();
+    CHECK(stats.read.bytes == expectedBytes);
+    CHECK(stats.transform.bytes == expectedBytes);
+    CHECK(stats.write.bytes == expectedBytes);
+    CHECK(stats.read.chunks == stats.write.chunks);
+    CHECK(stats.read.chunks > names.size());
+    CHECK(stats.elapsedSeconds > 0.0);
+    CHECK(stats.write.throughput() > 0.0);
+}
+
+// PosixFileSystem that counts whole-file reads, to show the mapped path
+// does not use them.
+class CountingPosixFileSystem : public PosixFileSystem {
+public:
+    int wholeFileReads = 0;
+
+    std::string readFile(const std::string& filename) override {
+        ++wholeFileReads;
+        return PosixFileSystem::readFile(filename);
+    }
+};
+
+struct PosixFixture {
+    std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / ("learn_doctest_" + std::to_string(::getpid()));
+    CountingPosixFileSystem* fs = new CountingPosixFileSystem();
+    SilentLogger* logger = new SilentLogger();
+    FileProcessor processor{std::unique_ptr<IFileSystem>(fs), nullptr, std::unique_ptr<ILogger>(logger)};
+
+    PosixFixture() { std::filesystem::create_directories(directory); }
+    ~PosixFixture() { std::filesystem::remove_all(directory); }
+
+    std::string path(const std::string& name) const { return (directory / name).string(); }
+};
+
+TEST_CASE("Pipelined processing stops cleanly on failures") {
+    FaultyFileSystem* fs = new FaultyFileSystem();
+    FileProcessor processor(std::unique_ptr<IFileSystem>(fs), nullptr, std::make_unique<SilentLogger>());
+    std::vector<std::string> names;
+    for (int i = 0; i < 20; ++i) {
+        names.push_back("part" + std::to_string(i));
+        fs->files[names.back()] = std::string(1000, 'p');
+    }
+
+    fs->unreadable = "part3";
+    std::vector<std::string> results = processor.processFilesPipelined(names, 64, 2);
+    CHECK(results.size() == 19);
+    CHECK(fs->files.count("part3.processed") == 0);
+
+    fs->unreadable.clear();
+    fs->unwritable = "part5.processed";
+    results = processor.processFilesPipelined(names, 64, 2);
+    CHECK(results.size() == 19);
+    CHECK(fs->files.count("part5.processed") == 0);
+    fs->unwritable.clear();
+
+    fs->throwOnRead = "part7";
+    CHECK_THROWS_AS(processor.processFilesPipelined(names, 64, 2), std::runtime_error);
+
+    fs->throwOnRead.clear();
+    fs->files.erase("part12.processed");
+    fs->throwOnAppend = "part12.processed";
+    CHECK_THROWS_AS(processor.processFilesPipelined(names, 64, 2), std::runtime_error);
+    CHECK(fs->files.count("part12.processed") == 0);
+}
+
+TEST_CASE_FIXTURE(PosixFixture, "PosixFileSystem basic operations") {
+    const std::string file = path("data.txt");
+    CHECK_FALSE(fs->fileExists(file));
+    CHECK(fs->writeFile(file, "0123456789"));
+    CHECK(fs->fileExists(file));
+    CHECK(fs->getFileSize(file) == 10);
+
+    char buffer[4];
+    CHECK(fs->readChunk(file, 8, buffer, sizeof(buffer)) == 2);
+    CHECK(std::string(buffer, 2) == "89");
+    CHECK(fs->appendChunk(file, "ab", 2));
+    CHECK(fs->readFile(file) == "0123456789ab");
+
+    std::unique_ptr<FileView> view = fs->openView(file);
+    REQUIRE(view != nullptr);
+    CHECK(std::string(view->data(), view->size()) == "0123456789ab");
+
+    CHECK(fs->deleteFile(file));
+    CHECK_FALSE(fs->fileExists(file));
+    CHECK(fs->openView(file) == nullptr);
+}
+
+TEST_CASE_FIXTURE(PosixFixture, "Posix backups copy in the kernel and skip unchanged files") {
+    const std::string file = path("source.bin");
+    std::string content(2 * FileProcessor::BACKUP_CHUNK_SIZE, 's');
+    CHECK(fs->writeFile(file, content));
+    std::filesystem::last_write_time(file, std::filesystem::last_write_time(file) - std::chrono::hours(1));
+
+    FileInfo info = fs->getFileInfo(file);
+    CHECK(info.exists);
+    CHECK(info.size == content.size());
+    CHECK(info.modifiedNanos != 0);
+    CHECK_FALSE(fs->getFileInfo(path("missing")).exists);
+
+    CHECK(processor.backupFile(file));
+    CHECK(processor.backupFile(file));
+    CHECK(fs->wholeFileReads == 0);
+    CHECK(processor.getBackupStats().fullCopies == 1);
+    CHECK(processor.getBackupStats().skipped == 1);
+
+    CHECK(fs->writeChunkAt(file, 3, "xyz", 3));
+    CHECK_FALSE(fs->writeChunkAt(path("missing"), 0, "x", 1));
+    CHECK(processor.backupFile(file));
+    CHECK(processor.getBackupStats().incrementalUpdates == 1);
+    CHECK(processor.getBackupStats().chunksRewritten == 1);
+    CHECK(fs->readFile(file + ".backup") == fs->readFile(file));
+
+    CHECK(fs->copyFile(file, path("copy.bin")));
+    CHECK(fs->readFile(path("copy.bin")) == fs->readFile(file));
+    CHECK_FALSE(fs->copyFile(path("missing"), path("copy.bin")));
+}
+
+TEST_CASE_FIXTURE(PosixFixture, "Async logger writes every record from many threads before shutdown") {
+    const std::string logFile = path("threads.log");
+    const int threads = 4;
+    const int perThread = 2500;
+    {
+        AsyncFileLogger logger(std::make_unique<PosixFileSystem>(), logFile, 64);
+        logger.setMinimumLevel(LogLevel::Info);
+        CHECK_FALSE(logger.isEnabled(LogLevel::Debug));
+
+        std::vector<std::thread> producers;
+        for (int t = 0; t < threads; ++t) {
+            producers.emplace_back([&logger, t, perThread]() {
+                for (int i = 0; i < perThread; ++i) {
+                    logger.log(LogLevel::Info, t, ' ', i);
+                    logger.log(LogLevel::Debug, "filtered");
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        logger.error(std::string(2 * AsyncFileLogger::MAX_MESSAGE_SIZE, 'e'));
+    }
+
+    std::vector<std::string> lines = splitLines(fs->readFile(logFile));
+    REQUIRE(lines.size() == threads * perThread + 1);
+    CHECK(lines.back() == "[ERROR] " + std::string(AsyncFileLogger::MAX_MESSAGE_SIZE, 'e'));
+
+    std::vector<int> next(threads, 0);
+    bool ordered = true;
+    for (size_t i = 0; i + 1 < lines.size(); ++i) {
+        std::istringstream fields(lines[i].substr(7));
+        int t = 0;
+        int n = 0;
+        fields >> t >> n;
+        ordered = ordered && lines[i].compare(0, 7, "[INFO] ") == 0 && n == next[t]++;
+    }
+    CHECK(ordered);
+}
+
+TEST_CASE_FIXTURE(PosixFixture, "Mapped files are transformed without reading them into memory") {
+    CHECK(fs->writeFile(path("small.txt"), "mapped input"));
+    CHECK(processor.processFile(path("small.txt"), path("small.out")));
+    CHECK(fs->wholeFileReads == 0);
+    CHECK(fs->readFile(path("small.out")) == "PROCESSED: MAPPED INPUT");
+
+    std::string large(FileProcessor::MAX_IN_MEMORY_SIZE + FileProcessor::DEFAULT_CHUNK_SIZE / 2, 'q');
+    CHECK(fs->writeFile(path("large.txt"), large));
+    CHECK(processor.processFile(path("large.txt"), path("large.out")));
+    CHECK(fs->getFileSize(path("large.out")) == 11 + large.size());
+    CHECK(processor.getTotalProcessedSize() == 12 + large.size());
+
+    CHECK(fs->writeFile(path("empty.txt"), ""));
+    CHECK_FALSE(processor.processFile(path("empty.txt"), path("empty.out")));
+}
+
+TEST_CASE_FIXTURE(PosixFixture, "Large mapped files can be processed in place") {
+    const std::string file = path("inplace.txt");
+    std::string content(FileProcessor::MAX_IN_MEMORY_SIZE + 100, 'i');
+    CHECK(fs->writeFile(file, content));
+    CHECK(fs->isSameFile(file, path("./inplace.txt")));
+    CHECK_FALSE(fs->isSameFile(file, path("other.txt")));
+
+    CHECK(processor.processFile(file, path("./inplace.txt")));
+    CHECK(fs->readFile(file) == "PROCESSED: " + std::string(content.size(), 'I'));
+    CHECK_FALSE(fs->fileExists(path("./inplace.txt") + ".tmp"));
+}
+
+TEST_CASE_FIXTURE(PosixFixture, "Async file systems read and write whole files") {
+    std::vector<std::unique_ptr<IAsyncFileSystem>> systems;
+    systems.push_back(std::make_unique<ThreadPoolAsyncFileSystem>(2));
+    if (IoUringFileSystem::isAvailable()) {
+        systems.push_back(std::make_unique<IoUringFileSystem>(4));
+    }
+    systems.push_back(createAsyncFileSystem());
+
+    std::string large(3 * 1024 * 1024 + 5, 'z');
+    large[12345] = 'y';
+    for (auto& async : systems) {
+        CHECK(async->writeFileAsync(path("large.bin"), large).get());
+        CHECK(async->readFileAsync(path("large.bin")).get() == large);
+        CHECK(async->writeFileAsync(path("empty.bin"), "").get());
+        CHECK(async->readFileAsync(path("empty.bin")).get().empty());
+        CHECK_THROWS_AS(async->readFileAsync(path("missing.bin")).get(), std::runtime_error);
+        CHECK_FALSE(async->writeFileAsync(path("no/such/dir.bin"), "x").get());
+    }
+}
+
+TEST_CASE_FIXTURE(PosixFixture, "An io_uring file system shuts down with requests still queued") {
+    if (!IoUringFileSystem::isAvailable()) {
+        return;
+    }
+    std::string content(256 * 1024, 'q');
+    std::vector<std::future<bool>> writes;
+    {
+        IoUringFileSystem ring(1);
+        for (int i = 0; i < 8; ++i) {
+            writes.push_back(ring.writeFileAsync(path("queued" + std::to_string(i)), content));
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        REQUIRE(writes[i].wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+        CHECK(writes[i].get());
+        CHECK(fs->readFile(path("queued" + std::to_string(i))) == content);
+    }
+}
+
+TEST_CASE_FIXTURE(PosixFixture, "Multiple files are processed through the async file system") {
+    std::vector<std::string> names;
+    size_t expectedSize = 0;
+    for (int i = 0; i < 300; ++i) {
+        names.push_back(path("batch" + std::to_string(i)));
+        if (i != 42) {
+            std::string content = "batch " + std::to_string(i);
+            fs->writeFile(names.back(), content);
+            expectedSize += content.size();
+        }
+    }
+    names.push_back(path("oversized"));
+    fs->writeFile(names.back(), std::string(1000001, 'o'));
+
+    for (bool useRing : {false, true}) {
+        if (useRing && !IoUringFileSystem::isAvailable()) {
+            continue;
+        }
+        CAPTURE(useRing);
+        if (useRing) {
+            processor.setAsyncFileSystem(std::make_unique<IoUringFileSystem>(16));
+        } else {
+            processor.setAsyncFileSystem(std::make_unique<ThreadPoolAsyncFileSystem>(4));
+        }
+        size_t before = processor.getTotalProcessedSize();
+        int errorsBefore = logger->errors;
+
+        std::vector<std::string> results = processor.processMultipleFilesAsync(names, 64);
+
+        CHECK(results.size() == 299);
+        CHECK(results[42] == names[43] + ".processed");
+        CHECK(fs->readFile(names[7] + ".processed") == "PROCESSED: BATCH 7");
+        CHECK_FALSE(fs->fileExists(names.back() + ".processed"));
+        CHECK(processor.getTotalProcessedSize() - before == expectedSize);
+        CHECK(logger->errors - errorsBefore == 2);
+    }
+}